@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QCache>
+#include <QPixmap>
+
+#include "QtUtility/data/qsingleton.hpp"
+#include "QtUtility/export.hpp"
+
+namespace QtUtility {
+namespace media {
+
+// Full resolution pixmaps of image files, shared by all galleries. The least recently used are
+// evicted once the decoded size exceeds the byte budget, and read again from disk when needed.
+// Gui thread only, as QPixmap is.
+class QTUTILITY_EXPORT PixmapCache : public QSingleton<PixmapCache>
+{
+    Q_OBJECT
+    friend class QSingleton<PixmapCache>;
+
+public:
+    static constexpr qint64 DEFAULT_BYTE_BUDGET = 256 * 1024 * 1024;
+
+    // decodes the file unless cached, null if it cannot be read
+    QPixmap pixmap(const QString &path);
+    // evicts down to the new budget right away
+    void setByteBudget(qint64 bytes);
+    qint64 byteBudget() const { return m_cache.maxCost(); }
+    qint64 cachedBytes() const { return m_cache.totalCost(); }
+
+private:
+    PixmapCache();
+
+    // keyed by path and modification time, so an overwritten plot is read again
+    QCache<QString, QPixmap> m_cache;
+};
+
+} // namespace media
+} // namespace QtUtility
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+
+#include "QtUtility/data/qsingleton.hpp"
+#include "QtUtility/export.hpp"
+
+namespace QtUtility {
+namespace media {
+
+// Decodes downscaled thumbnails of image files on the global thread pool. Thumbnails are cached
+// in memory and on disk, keyed by path and modification time, so each file is decoded once. The
+// disk cache is pruned by age and size, files that fail to decode are not tried again until
+// they change.
+class QTUTILITY_EXPORT ThumbnailLoader : public QSingleton<ThumbnailLoader>
+{
+    Q_OBJECT
+    friend class QSingleton<ThumbnailLoader>;
+
+public:
+    // largest side of a thumbnail
+    static constexpr int THUMBNAIL_SIZE = 100;
+    static constexpr qint64 DISK_CACHE_BYTES = 64 * 1024 * 1024;
+    static constexpr int DISK_CACHE_DAYS = 30;
+
+    // removes thumbnails older than the age limit, then the oldest ones until the rest fit
+    static void pruneDiskCache(const QString &dir, qint64 maxBytes, int maxDays);
+
+    // the cached thumbnail, otherwise a null image and thumbnailReady is emitted once loaded
+    QImage thumbnail(const QString &path);
+
+signals:
+    void thumbnailReady(const QString &path, const QImage &thumbnail);
+    // the file is not an image, it is not tried again until it changes
+    void thumbnailFailed(const QString &path);
+
+private:
+    ThumbnailLoader();
+    void finishLoading(const QString &key, const QString &path, const QImage &thumbnail);
+    void schedulePrune();
+
+    // cost is in bytes
+    QCache<QString, QImage> m_cache;
+    // keys being decoded, so a file is never queued twice
+    QSet<QString> m_loading;
+    // keys that could not be decoded
+    QSet<QString> m_failed;
+    QString m_cacheDir;
+    // thumbnails loaded since the disk cache was last pruned
+    int m_loadedSincePrune = 0;
+};
+
+} // namespace media
+} // namespace QtUtility
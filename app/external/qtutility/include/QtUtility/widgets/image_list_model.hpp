@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QIcon>
 #include <QPixmap>
 
 #include "QtUtility/export.hpp"
@@ -8,6 +9,8 @@
 namespace QtUtility {
 namespace widgets {
 
+// Images added by path are held as handles: the path and a thumbnail decoded off the gui thread.
+// Their full resolution pixmaps come from the shared PixmapCache when asked for.
 class QTUTILITY_EXPORT ImageListModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -17,13 +20,28 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     size_t count() const;
     QPixmap at(const size_t &index) const;
+    // empty for images added as pixmaps
+    QString pathAt(const size_t &index) const;
     void add(const QPixmap &pixmap);
+    void add(const QString &path);
     void remove(int index);
     void clear();
 
+private slots:
+    void onThumbnailReady(const QString &path, const QImage &thumbnail);
+
 private:
-    QList<QPixmap> m_images;
+    struct Image
+    {
+        QString path;
+        // only set for images added as pixmaps, there is no file to read them back from
+        QPixmap pixmap;
+        // null until the thumbnail is decoded
+        QIcon icon;
+    };
+
+    QList<Image> m_images;
 };
 
 } // namespace widgets
-} // namespace QtUtility
\ No newline at end of file
+} // namespace QtUtility
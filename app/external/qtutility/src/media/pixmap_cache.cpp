@@ -0,0 +1,43 @@
+#include "QtUtility/media/pixmap_cache.hpp"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace {
+qint64 pixmapBytes(const QPixmap &pixmap)
+{
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+} // namespace
+
+namespace QtUtility {
+namespace media {
+
+PixmapCache::PixmapCache()
+    : m_cache(DEFAULT_BYTE_BUDGET)
+{}
+
+QPixmap PixmapCache::pixmap(const QString &path)
+{
+    QFileInfo info(path);
+    if (!info.exists())
+        return QPixmap();
+    auto key = QString("%1@%2").arg(info.absoluteFilePath()).arg(
+        info.lastModified().toMSecsSinceEpoch());
+    if (auto cached = m_cache.object(key))
+        return *cached;
+    QPixmap pixmap(path);
+    if (pixmap.isNull())
+        return pixmap;
+    // a pixmap larger than the budget is not kept, QCache deletes it on insertion
+    m_cache.insert(key, new QPixmap(pixmap), pixmapBytes(pixmap));
+    return pixmap;
+}
+
+void PixmapCache::setByteBudget(qint64 bytes)
+{
+    m_cache.setMaxCost(bytes);
+}
+
+} // namespace media
+} // namespace QtUtility
@@ -0,0 +1,119 @@
+#include "QtUtility/media/thumbnail_loader.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+namespace {
+constexpr qsizetype MEMORY_CACHE_BYTES = 32 * 1024 * 1024;
+// plots are written again with a new modification time on every run, so the disk cache is also
+// pruned while the application runs
+constexpr int PRUNE_INTERVAL = 256;
+
+QString cacheKey(const QFileInfo &info)
+{
+    return QString("%1@%2").arg(info.absoluteFilePath()).arg(
+        info.lastModified().toMSecsSinceEpoch());
+}
+
+QImage decodeThumbnail(const QString &path, int size)
+{
+    QImageReader reader(path);
+    auto fullSize = reader.size();
+    // formats supporting it decode at the reduced size directly
+    if (fullSize.isValid() && (fullSize.width() > size || fullSize.height() > size))
+        reader.setScaledSize(fullSize.scaled(size, size, Qt::KeepAspectRatio));
+    return reader.read();
+}
+} // namespace
+
+namespace QtUtility {
+namespace media {
+
+ThumbnailLoader::ThumbnailLoader()
+    : m_cache(MEMORY_CACHE_BYTES)
+    , m_cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails")
+{
+    QDir().mkpath(m_cacheDir);
+    schedulePrune();
+}
+
+void ThumbnailLoader::pruneDiskCache(const QString &dir, qint64 maxBytes, int maxDays)
+{
+    auto files = QDir(dir).entryInfoList({"*.png"}, QDir::Files, QDir::Time | QDir::Reversed);
+    const auto oldest = QDateTime::currentDateTime().addDays(-maxDays);
+    qint64 total = 0;
+    for (const auto &file : files)
+        total += file.size();
+    // oldest first
+    for (const auto &file : files) {
+        if (file.lastModified() >= oldest && total <= maxBytes)
+            break;
+        if (QFile::remove(file.absoluteFilePath()))
+            total -= file.size();
+    }
+}
+
+void ThumbnailLoader::schedulePrune()
+{
+    m_loadedSincePrune = 0;
+    QThreadPool::globalInstance()->start(
+        [dir = m_cacheDir]() { pruneDiskCache(dir, DISK_CACHE_BYTES, DISK_CACHE_DAYS); });
+}
+
+QImage ThumbnailLoader::thumbnail(const QString &path)
+{
+    QFileInfo info(path);
+    if (!info.exists())
+        return QImage();
+    auto key = cacheKey(info);
+    if (auto cached = m_cache.object(key))
+        return *cached;
+    if (m_loading.contains(key) || m_failed.contains(key))
+        return QImage();
+    m_loading.insert(key);
+
+    auto hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+    auto cacheFile = QDir(m_cacheDir).absoluteFilePath(QString::fromLatin1(hash) + ".png");
+    QThreadPool::globalInstance()->start([this, key, path, cacheFile]() {
+        // QImage is safe to use off the gui thread, QPixmap is not
+        QImage thumbnail(cacheFile);
+        if (thumbnail.isNull()) {
+            thumbnail = decodeThumbnail(path, THUMBNAIL_SIZE);
+            if (!thumbnail.isNull() && !thumbnail.save(cacheFile, "PNG"))
+                qWarning() << "Cannot write thumbnail cache" << cacheFile;
+        }
+        QMetaObject::invokeMethod(
+            this,
+            [this, key, path, thumbnail]() { finishLoading(key, path, thumbnail); },
+            Qt::QueuedConnection);
+    });
+    return QImage();
+}
+
+void ThumbnailLoader::finishLoading(const QString &key,
+                                    const QString &path,
+                                    const QImage &thumbnail)
+{
+    m_loading.remove(key);
+    if (thumbnail.isNull()) {
+        // the key changes with the modification time, a rewritten file is tried again
+        m_failed.insert(key);
+        qWarning() << "Cannot decode image" << path;
+        emit thumbnailFailed(path);
+        return;
+    }
+    m_cache.insert(key, new QImage(thumbnail), thumbnail.sizeInBytes());
+    if (++m_loadedSincePrune >= PRUNE_INTERVAL)
+        schedulePrune();
+    emit thumbnailReady(path, thumbnail);
+}
+
+} // namespace media
+} // namespace QtUtility
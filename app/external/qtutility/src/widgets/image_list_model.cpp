@@ -1,13 +1,33 @@
 #include "QtUtility/widgets/image_list_model.hpp"
 
-#include <QIcon>
+#include "QtUtility/media/pixmap_cache.hpp"
+#include "QtUtility/media/thumbnail_loader.hpp"
+
+using ThumbnailLoader = QtUtility::media::ThumbnailLoader;
+
+namespace {
+const QIcon &placeholderIcon()
+{
+    static const QIcon ICON = []() {
+        QPixmap pixmap(ThumbnailLoader::THUMBNAIL_SIZE, ThumbnailLoader::THUMBNAIL_SIZE);
+        pixmap.fill(Qt::lightGray);
+        return QIcon(pixmap);
+    }();
+    return ICON;
+}
+} // namespace
 
 namespace QtUtility {
 namespace widgets {
 
 ImageListModel::ImageListModel(QObject *parent)
     : QAbstractListModel(parent)
-{}
+{
+    connect(&ThumbnailLoader::instance(),
+            &ThumbnailLoader::thumbnailReady,
+            this,
+            &ImageListModel::onThumbnailReady);
+}
 
 int ImageListModel::rowCount(const QModelIndex &parent) const
 {
@@ -19,8 +39,12 @@ QVariant ImageListModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid() || index.row() >= m_images.size())
         return QVariant();
-    if (role == Qt::DecorationRole)
-        return QIcon(m_images.at(index.row()));
+    if (role == Qt::DecorationRole) {
+        const auto &icon = m_images.at(index.row()).icon;
+        return icon.isNull() ? placeholderIcon() : icon;
+    }
+    if (role == Qt::ToolTipRole)
+        return m_images.at(index.row()).path;
     return QVariant();
 }
 
@@ -31,15 +55,40 @@ size_t ImageListModel::count() const
 
 QPixmap ImageListModel::at(const size_t &index) const
 {
-    if (index < 0 || index > count())
+    if (index >= count())
         return QPixmap();
-    return m_images.at(index);
+    const auto &image = m_images.at(index);
+    if (!image.pixmap.isNull())
+        return image.pixmap;
+    return media::PixmapCache::instance().pixmap(image.path);
+}
+
+QString ImageListModel::pathAt(const size_t &index) const
+{
+    if (index >= count())
+        return QString();
+    return m_images.at(index).path;
 }
 
 void ImageListModel::add(const QPixmap &pixmap)
 {
     beginInsertRows(QModelIndex(), rowCount(), rowCount());
-    m_images.append(pixmap);
+    m_images.append({QString(),
+                     pixmap,
+                     QIcon(pixmap.scaled(ThumbnailLoader::THUMBNAIL_SIZE,
+                                         ThumbnailLoader::THUMBNAIL_SIZE,
+                                         Qt::KeepAspectRatio,
+                                         Qt::SmoothTransformation))});
+    endInsertRows();
+}
+
+void ImageListModel::add(const QString &path)
+{
+    // cached thumbnails are shown right away, the others arrive through onThumbnailReady
+    auto thumbnail = ThumbnailLoader::instance().thumbnail(path);
+    beginInsertRows(QModelIndex(), rowCount(), rowCount());
+    m_images.append(
+        {path, QPixmap(), thumbnail.isNull() ? QIcon() : QIcon(QPixmap::fromImage(thumbnail))});
     endInsertRows();
 }
 
@@ -59,5 +108,19 @@ void ImageListModel::clear()
     endResetModel();
 }
 
+void ImageListModel::onThumbnailReady(const QString &path, const QImage &thumbnail)
+{
+    QIcon icon;
+    for (int row = 0; row < m_images.size(); ++row) {
+        auto &image = m_images[row];
+        if (image.path != path || !image.icon.isNull())
+            continue;
+        if (icon.isNull())
+            icon = QIcon(QPixmap::fromImage(thumbnail));
+        image.icon = icon;
+        emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+    }
+}
+
 } // namespace widgets
-} // namespace QtUtility
\ No newline at end of file
+} // namespace QtUtility
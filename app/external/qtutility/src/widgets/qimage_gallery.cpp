@@ -1,7 +1,10 @@
 #include "QtUtility/widgets/qimage_gallery.hpp"
 
 #include <QDir>
+#include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QImageReader>
 #include <QLabel>
 #include <QListView>
 #include <QPushButton>
@@ -11,11 +14,12 @@
 #include "QtUtility/widgets/image_list_model.hpp"
 #include <QtUtility/data/constexpr_qstring.hpp>
 #include <QtUtility/media/media.hpp>
+#include <QtUtility/media/thumbnail_loader.hpp>
 
 using ConstLatin1String = QtUtility::data::ConstLatin1String;
 
 namespace {
-constexpr uint ICON_SIZE = 100;
+constexpr uint ICON_SIZE = QtUtility::media::ThumbnailLoader::THUMBNAIL_SIZE;
 constexpr uint IMAGE_WIDTH = 450;
 constexpr ConstLatin1String NO_SELECTION_TEXT = "No Image Selected.";
 } // namespace
@@ -75,10 +79,13 @@ void QImageGallery::add(const QPixmap &image)
 
 void QImageGallery::add(const QString &path)
 {
-    QPixmap image(path);
-    if (image.isNull())
+    // only the header is read here to reject files that are not images, the thumbnail is
+    // decoded on the thread pool and the full image once selected
+    if (QImageReader::imageFormat(path).isEmpty())
         return;
-    add(image);
+    m_images->add(path);
+    if (m_images->count() == 1)
+        emit hasImage(true);
 }
 
 void QImageGallery::remove(const size_t &index)
@@ -105,9 +112,21 @@ void QImageGallery::downloadAllClicked()
     QDir target(selectedDir + "/graphs");
     target.mkpath(".");
     for (int i = 0; i < m_images->count(); ++i) {
-        QString path = target.absoluteFilePath(QString("graph%1.png").arg(i + 1));
-        if (!m_images->at(i).save(path, "PNG")) {
-            qCritical() << "Failed to save png: " << path;
+        auto source = m_images->pathAt(i);
+        // files are copied as they are, only images added as pixmaps are encoded
+        if (source.isEmpty()) {
+            QString path = target.absoluteFilePath(QString("graph%1.png").arg(i + 1));
+            if (!m_images->at(i).save(path, "PNG")) {
+                qCritical() << "Failed to save png: " << path;
+                return;
+            }
+            continue;
+        }
+        QString path = target.absoluteFilePath(
+            QString("graph%1.%2").arg(i + 1).arg(QFileInfo(source).suffix()));
+        QFile::remove(path);
+        if (!QFile::copy(source, path)) {
+            qCritical() << "Failed to copy graph: " << source << " to " << path;
             return;
         }
     }
@@ -30,6 +30,12 @@ signals:
 
 public slots:
     void onSelectionChanged();
+    // replaces the selected blocks by a composite block holding them
+    void groupSelectedBlocks();
+    // expands the selected composite block in a dialog, it is collapsed again once closed
+    void editSelectedComposite();
+    // lays out the current graph on a worker thread, positions are applied in one batch
+    void layoutCurrentGraph();
 
 private slots:
     void onTabCreated(QWidget *view);
@@ -26,7 +26,13 @@ constexpr uint INT_SPIN_BOX_MIN_WIDTH = 60;
 constexpr uint DOUBLE_SPIN_BOX_MAX_WIDTH = 80;
 constexpr uint DOUBLE_SPIN_BOX_MIN_WIDTH = 75;
 
-enum PortTableColIndex { COL_PORT_ID = 0, COL_TYPE_TAG, COL_ANNOTATION, COL_CAPTION };
+enum PortTableColIndex {
+    COL_PORT_ID = 0,
+    COL_TYPE_TAG,
+    COL_ANNOTATION,
+    COL_CAPTION,
+    COL_PERSISTENCE
+};
 
 constexpr ConstLatin1String CONNECTION_STYLE =
     R"(
@@ -100,15 +106,6 @@ constexpr uint MINUTE_MSECS = 60000;
 constexpr ConstLatin1String DATA_PORT_ID = "DataNode";
 constexpr ConstLatin1String FUNCTION_PORT_ID = "FunctionNode";
 
-inline bool isFunctionNode(QtNodes::NodeDataType node)
-{
-    return node.id == constants::FUNCTION_PORT_ID;
-}
-inline bool isDataNode(QtNodes::NodeDataType node)
-{
-    return node.id == constants::DATA_PORT_ID;
-}
-
 inline QString sanitizeCaption(const QString &caption)
 {
     QRegularExpression invalidCharsRegex("[^a-zA-Z0-9._-]+");
@@ -130,15 +127,57 @@ constexpr ConstLatin1String CONF_PATH = "conf/base/";
 // %1 is the kedro project name
 constexpr ConstLatin1String SOURCE_PATH = "src/%1/";
 constexpr ConstLatin1String RAW_DATA_PATH = "data/01_raw/";
+constexpr ConstLatin1String INTERMEDIATE_PATH = "data/02_intermediate/";
 constexpr ConstLatin1String MODELS_PATH = "data/06_models/";
+constexpr ConstLatin1String MODEL_OUTPUT_PATH = "data/07_model_output/";
 constexpr ConstLatin1String REPORTING_PATH = "data/08_reporting/";
 
+// single quoted yaml scalar, the only character to escape inside is the quote itself
+inline QString yamlQuote(const QString &value)
+{
+    return '\'' + QString(value).replace('\'', "''") + '\'';
+}
+
 // templates for gnerating files
 constexpr ConstLatin1String CATALOG_YML_ENTRY =
     R"(%1:
   type: %2
   filepath: %3
   )";
+// datasets kept in memory are handed over without copying
+constexpr ConstLatin1String CATALOG_YML_MEMORY_ENTRY =
+    R"(%1:
+  type: MemoryDataset
+  copy_mode: assign
+  )";
+// appended to a parquet or feather entry, %1 is the codec and %2 the level
+constexpr ConstLatin1String CATALOG_YML_COMPRESSION_ARGS =
+    R"(save_args:
+    compression: %1
+    compression_level: %2
+  )";
+// appended to an uncompressed parquet or feather entry, otherwise arrow picks its default codec.
+// %1 is the name the format uses for no codec, none for parquet and uncompressed for feather
+constexpr ConstLatin1String CATALOG_YML_UNCOMPRESSED_ARGS =
+    R"(save_args:
+    compression: %1
+  )";
+// appended to a pickle entry, %1 is the codec used on the file stream
+constexpr ConstLatin1String CATALOG_YML_STREAM_COMPRESSION_ARGS =
+    R"(fs_args:
+    open_args_save:
+      mode: wb
+      compression: %1
+    open_args_load:
+      mode: rb
+      compression: %1
+  )";
+// appended to a pickle entry, %1 is the compression level
+constexpr ConstLatin1String CATALOG_YML_JOBLIB_ARGS =
+    R"(backend: joblib
+  save_args:
+    compress: %1
+  )";
 
 // %1 is the list of all pipeline objects
 constexpr ConstLatin1String PIPELINE_PY =
@@ -164,6 +203,9 @@ const QString TYPE_MISMATCH = "Failed to connect '%1'. The expected input is of
                               "these two data types are the same.";
 const QString SINGULAR_SIGNATURE
     = "The expected function signature is singular. Please check the connection.";
+const QString CHUNKED_INPUT = "The data is read in chunks and this block cannot stream it. "
+                              "Set the chunk size of the data source to 0 or connect it to a "
+                              "block that processes chunks.";
 
 const QString WARN_MANUAL_OVERRIDE = "The tag you entered already "
                                      "exists. Do you want to "
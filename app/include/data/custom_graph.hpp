@@ -1,29 +1,97 @@
 #pragma once
 
 #include "ui/models/uid_manager.hpp"
+#include <set>
 #include <QtNodes/DirectedAcyclicGraphModel>
 
 class FdfBlockModel;
 class DataSourceModel;
 class FuncOutModel;
+class DataOutModel;
+struct GraphSnapshot;
+namespace QtNodes {
+class BasicGraphicsScene;
+}
 
 class CustomGraph : public QtNodes::DirectedAcyclicGraphModel
 {
     Q_OBJECT
 public:
-    CustomGraph(std::shared_ptr<QtNodes::NodeDelegateModelRegistry> registry);
+    // groups graph mutations, uniqueness checks, port styling, propagation and the graphics
+    // items of an attached scene are deferred until the outermost batch commits
+    class Batch
+    {
+    public:
+        // KeepScene for callers that reach the graphics items of what they just added, e.g. paste
+        enum SceneUpdate { DeferScene, KeepScene };
+        explicit Batch(CustomGraph &graph, SceneUpdate sceneUpdate = DeferScene)
+            : m_graph(graph)
+            , m_deferScene(sceneUpdate == DeferScene)
+        {
+            m_graph.beginBatch(m_deferScene);
+        }
+        ~Batch() { m_graph.commit(m_deferScene); }
+        Batch(const Batch &) = delete;
+        Batch &operator=(const Batch &) = delete;
+
+    private:
+        CustomGraph &m_graph;
+        bool m_deferScene;
+    };
+
+    // the interner is shared with the uid manager of the same project
+    CustomGraph(std::shared_ptr<QtNodes::NodeDelegateModelRegistry> registry,
+                std::shared_ptr<StringInterner> interner = std::make_shared<StringInterner>());
+    // ports of the blocks built by this graph are bound to its uid manager, the one of the tab
+    // once set, otherwise one owned by the graph
+    void setUIDManager(UIDManager *uidManager) { m_uidManager = uidManager; }
+    UIDManager *uidManager() const { return m_uidManager ? m_uidManager : m_ownUIDManager.get(); }
+    std::shared_ptr<StringInterner> interner() const { return m_interner; }
+    QtNodes::NodeId addNode(QString const nodeType) override;
+    void loadNode(QJsonObject const &nodeJson) override;
+    // a saved file can pair ports of different kinds, those connections are dropped
+    void addConnection(QtNodes::ConnectionId const connectionId) override;
+    void beginBatch(bool deferScene = true);
+    void commit(bool deferScene = true);
+    // the scene builds its items from sceneNodeCreated and sceneConnectionCreated instead of
+    // nodeCreated and connectionCreated, so a batch creates them once it commits
+    void attachScene(QtNodes::BasicGraphicsScene *scene);
+    bool inBatch() const { return m_batchDepth > 0; }
     std::vector<DataSourceModel *> getDataSourceModels() const;
     std::vector<FuncOutModel *> getFuncOutModels() const;
+    std::vector<DataOutModel *> getDataOutModels() const;
     FdfBlockModel *getBlockByCaption(const QString &caption) const;
     bool connectionPossible(QtNodes::ConnectionId const connectionId) const override;
+    // the geometry sizes blocks for their ports, room for painted content is added here
+    bool setNodeData(QtNodes::NodeId nodeId, QtNodes::NodeRole role, QVariant value) override;
     // rename out ports that are duplicates
     void makeOutPortsUnique(const QtNodes::NodeId &nodeId,
                             FdfBlockModel *block,
                             const QtNodes::PortIndex &index);
-    bool verifyBlocksValidity() const;
+    // validity is maintained as nodes, connections and inputs change, so these only
+    // re-check the blocks changed since the last query
+    bool allBlocksValid();
+    std::unordered_map<QtNodes::NodeId, QStringList> validityIssues();
+    // number of weakly connected components
+    size_t componentCount();
+    // marks the block dirty, dirty blocks push their outputs once and in topological order
+    void requestPropagation(const QtNodes::NodeId nodeId);
+    // immutable copy of the graph that other threads can read while editing goes on. Only
+    // the blocks changed since the previous snapshot are copied again
+    std::shared_ptr<const GraphSnapshot> snapshot();
+    // moves the blocks into a new collapsed composite block, connections crossing the group go
+    // through boundary blocks. Returns the composite, or an invalid id when a function crosses
+    // it or a data or output block is in the group
+    QtNodes::NodeId groupIntoComposite(const std::unordered_set<QtNodes::NodeId> &nodeIds);
 
 signals:
     void dataSourceModelImportClicked(const QtNodes::NodeId nodeId);
+    // emitted once when the outermost batch commits, after the nodes updated inside it
+    void batchCommitted();
+    // nodeCreated and connectionCreated, held back while a batch defers the scene
+    void sceneNodeCreated(const QtNodes::NodeId nodeId);
+    void sceneConnectionCreated(const QtNodes::ConnectionId connectionId);
+    void validityChanged(const QtNodes::NodeId nodeId, bool valid);
 
 private:
     void initBlockConnections(const QtNodes::NodeId nodeId, FdfBlockModel *block);
@@ -39,13 +107,62 @@ private:
     // to set port colours for function nodes
     void stylePorts(const QtNodes::NodeId &nodeId, FdfBlockModel *block);
     void makeOutPortsUnique(const QtNodes::NodeId &nodeId, FdfBlockModel *block);
+    void releaseOutPortCaptions(const QtNodes::NodeId nodeId);
+    void markValidityDirty(const QtNodes::NodeId nodeId);
+    void updateValidity();
+    // union-find over the nodes, rebuilt after deletions
+    QtNodes::NodeId findComponent(QtNodes::NodeId nodeId);
+    void uniteComponents(const QtNodes::NodeId first, const QtNodes::NodeId second);
+    void rebuildComponents();
+    size_t topologicalRank(const QtNodes::NodeId nodeId);
+    void processPropagation();
+    // marks the node to be checked at commit, returns false outside a batch
+    bool deferUntilCommit(const QtNodes::NodeId nodeId);
+    // emits nodeUpdated, inside a batch once per node when it commits
+    void notifyNodeUpdated(const QtNodes::NodeId nodeId);
 
 private:
-    // tracks node captions for uniqueness
-    std::unordered_map<QString, QtNodes::NodeId> m_usedNodeCaptions;
-    std::unordered_set<QtNodes::NodeId> m_trackedNodes;
+    std::shared_ptr<StringInterner> m_interner;
+    UIDManager *m_uidManager = nullptr;
+    // destroyed before the blocks, it detaches their ports
+    std::unique_ptr<UIDManager> m_ownUIDManager;
+    // tracks node captions for uniqueness, in both directions
+    std::unordered_map<Atom, QtNodes::NodeId> m_usedNodeCaptions;
+    std::unordered_map<QtNodes::NodeId, Atom> m_nodeCaptions;
     // tracks out port names for uniqueness, index is necessary for uniqueness amongst the node itself
-    std::unordered_map<QString, std::pair<QtNodes::NodeId, QtNodes::PortIndex>> m_usedOutPortCaptions;
+    std::unordered_map<Atom, std::pair<QtNodes::NodeId, QtNodes::PortIndex>> m_usedOutPortCaptions;
+    // registered name of each out port of a node, the empty atom while not registered
+    std::unordered_map<QtNodes::NodeId, std::vector<Atom>> m_nodeOutPortCaptions;
+    // next "_N" suffix to try for a base name
+    std::unordered_map<Atom, uint> m_nextCaptionSuffix;
+    std::unordered_map<Atom, uint> m_nextOutPortSuffix;
     std::unordered_set<QtNodes::NodeId> m_dataSourceNodes;
     std::unordered_set<QtNodes::NodeId> m_funcOutNodes;
+    std::unordered_set<QtNodes::NodeId> m_dataOutNodes;
+    // blocks waiting to push their outputs, ordered by topological rank
+    std::set<std::pair<size_t, QtNodes::NodeId>> m_dirtyNodes;
+    // cached position in the topological order, cleared when the graph structure changes
+    std::unordered_map<QtNodes::NodeId, size_t> m_topologicalRanks;
+    bool m_propagating = false;
+    uint m_batchDepth = 0;
+    uint m_sceneBatchDepth = 0;
+    // created inside a batch, handed to the scene when it commits
+    std::vector<QtNodes::NodeId> m_sceneNodes;
+    std::vector<QtNodes::ConnectionId> m_sceneConnections;
+    // nodes added or edited inside the batch, ordered by id so older nodes keep their captions
+    std::set<QtNodes::NodeId> m_pendingNodes;
+    std::set<QtNodes::NodeId> m_pendingPropagation;
+    std::set<QtNodes::NodeId> m_updatedNodes;
+    // nodes to re-check and the issues of the invalid ones
+    std::unordered_set<QtNodes::NodeId> m_validityDirty;
+    std::unordered_map<QtNodes::NodeId, QStringList> m_nodeIssues;
+    bool m_validationScheduled = false;
+    std::unordered_map<QtNodes::NodeId, QtNodes::NodeId> m_componentParent;
+    size_t m_componentCount = 0;
+    bool m_componentsStale = false;
+    // last snapshot handed out, the blocks changed since and whether nodes or connections were
+    // added or removed
+    std::shared_ptr<const GraphSnapshot> m_snapshot;
+    std::unordered_set<QtNodes::NodeId> m_snapshotDirty;
+    bool m_snapshotStructureDirty = true;
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QPointF>
+#include <QSizeF>
+#include <unordered_map>
+#include <vector>
+
+#include <QtNodes/Definitions>
+
+namespace data {
+
+// what the layout needs from a graph, copied on the gui thread so it can run on a worker
+struct LayoutGraph
+{
+    std::vector<QtNodes::NodeId> nodes;
+    // from the out node to the in node, duplicates are fine
+    std::vector<std::pair<QtNodes::NodeId, QtNodes::NodeId>> edges;
+    std::unordered_map<QtNodes::NodeId, QSizeF> sizes;
+};
+
+// Layered (Sugiyama style) layout of a DAG flowing left to right. Blocks are put in the layer
+// of their longest path from a source, layers are ordered by barycenter sweeps to reduce
+// crossings, then stacked and centered. Runs in O(E + V log V) per sweep.
+class LayeredLayout
+{
+public:
+    static constexpr double LAYER_SPACING = 120;
+    static constexpr double NODE_SPACING = 40;
+    static constexpr int SWEEPS = 4;
+
+    // top left position of every block, nodes left on a cycle are put in the first layer
+    static std::unordered_map<QtNodes::NodeId, QPointF> compute(const LayoutGraph &graph);
+};
+
+} // namespace data
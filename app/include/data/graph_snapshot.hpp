@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ui/models/fdf_block_model.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct GraphSnapshot;
+
+// out port of a block at the time of the snapshot
+struct PortSnapshot
+{
+    QString name;
+    PortKind kind;
+    FdfUID typeId = UIDManager::NONE_ID;
+    // a copy, readers on other threads do not go through the signature table
+    Signature signature;
+    NamedNode::Persistence persistence = NamedNode::Persistence::Default;
+};
+
+// immutable copy of what codegen and the other readers need from a block
+struct NodeSnapshot
+{
+    QtNodes::NodeId id;
+    FdfBlockModel::FdfType type;
+    QString typeString;
+    QString name;
+    QString functionName;
+    QString caption;
+    // names of the data on the ports, unconnected in ports are left out
+    QStringList inputs;
+    QStringList outputs;
+    std::vector<PortSnapshot> outPorts;
+    // in the order of the parameter schema
+    std::vector<std::pair<QString, QString>> parameters;
+    // some blocks take a params input even without parameters of their own
+    bool hasParameters = false;
+    // sub-pipeline of a composite block and its fingerprint
+    std::shared_ptr<const GraphSnapshot> pipeline;
+    QString fingerprint;
+
+    static std::shared_ptr<const NodeSnapshot> fromBlock(QtNodes::NodeId id,
+                                                         const FdfBlockModel &block);
+};
+
+// Immutable copy of the graph, safe to read from any thread. Snapshots taken one after the
+// other share the nodes that did not change in between.
+struct GraphSnapshot
+{
+    // increases with every snapshot that differs from the previous one
+    uint64_t version = 0;
+    std::unordered_map<QtNodes::NodeId, std::shared_ptr<const NodeSnapshot>> nodes;
+    std::vector<QtNodes::NodeId> topologicalOrder;
+    std::vector<QtNodes::ConnectionId> connections;
+
+    const NodeSnapshot *node(QtNodes::NodeId id) const;
+};
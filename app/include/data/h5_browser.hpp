@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QString>
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace data {
+
+// a dataset found in an HDF5 based file (.mat v7.3, .jld2)
+struct H5DatasetInfo
+{
+    // absolute path inside the file, e.g. /group/signal
+    QString path;
+    // extent of every axis, in the order seen by the python loader
+    std::vector<quint64> shape;
+    // integer, float, string, compound, reference...
+    QString typeClass;
+    // rank 0, or a MATLAB scalar which is stored as a 1x1 array
+    bool isScalar() const
+    {
+        return std::all_of(shape.begin(), shape.end(), [](quint64 extent) { return extent == 1; });
+    }
+};
+
+// Reads the object tree of HDF5 files without loading any dataset content.
+class H5Browser
+{
+public:
+    // false when the application was built without the HDF5 library
+    static bool isAvailable();
+    // all datasets of the file sorted by path, empty if the file cannot be read
+    static std::vector<H5DatasetInfo> listDatasets(const QString &filePath);
+    // "100:200" -> {100, 200}, "100:" -> {100, nullopt}, nullopt if the range is malformed
+    static std::optional<std::pair<quint64, std::optional<quint64>>> parseRange(
+        const QString &range);
+};
+
+} // namespace data
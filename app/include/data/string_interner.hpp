@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <QString>
+
+// handle of an interned string, equal atoms mean equal strings within one interner
+using Atom = uint32_t;
+
+// Per project table of the tags and captions used in the graph. Maps keyed by atoms hash and
+// compare integers, and every user of a repeated string shares the single stored copy.
+// The pool is append-only so atoms stay valid: names dropped by renames and deletions are kept
+// until the project is closed. It is bounded by the distinct names the project has handed out,
+// lookups of candidate names go through find() and do not grow it.
+class StringInterner
+{
+public:
+    inline static const Atom EMPTY_ATOM = 0;
+    inline static const Atom NO_ATOM = UINT32_MAX;
+    StringInterner();
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    Atom intern(const QString &string);
+    // the atom of an already interned string, NO_ATOM otherwise. Does not grow the table
+    Atom find(const QString &string) const;
+    // the reference stays valid for the lifetime of the interner
+    const QString &string(Atom atom) const;
+    size_t size() const { return m_strings.size(); }
+
+private:
+    // deque, so growing the table keeps the handed out references valid
+    std::deque<QString> m_strings;
+    std::unordered_map<QString, Atom> m_atoms;
+};
@@ -24,6 +24,7 @@ public:
     QtNodes::DagGraphicsScene *getScene() const { return m_scene; }
     QtNodes::GraphicsView *getView() const { return m_view; }
     std::unique_ptr<UIDManager> &getTabUIDManager() { return m_uidManager; }
+    std::shared_ptr<StringInterner> getInterner() const { return m_interner; }
     std::shared_ptr<QTemporaryDir> getTempDir() { return m_dir; }
     QDir getDataDir() { return m_dataDir; }
     QFileInfo getFileInfo() { return m_localFile; }
@@ -35,12 +36,23 @@ public:
     bool isNewFile() const;
     bool isValidProjectName(const QString &name);
     QString getBasename() const;
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private slots:
     void onDataSourceImportClicked(const QtNodes::NodeId nodeId);
     void postLoadProcess(const QJsonArray &nodesJsonArray);
+    void onViewScaleChanged(double scale);
 
 private:
+    // rendering setup for large pipelines, level of detail, caching and the optional GL viewport
+    void setupRendering();
+    // caches the connection path as a pixmap unless it would be too large at the view scale
+    void updateConnectionCache(const QtNodes::ConnectionId connectionId);
+    // hands a press on painted block content to the block, true if it handled it
+    bool pressContent(const QPointF &scenePos);
+
+    // tags and captions of this project, shared by the graph and the uid manager
+    std::shared_ptr<StringInterner> m_interner;
     CustomGraph *m_graph;
     QtNodes::DagGraphicsScene *m_scene;
     QtNodes::GraphicsView *m_view;
@@ -51,4 +63,7 @@ private:
     QFileInfo m_localFile;
     // UID Manager for this tab
     std::unique_ptr<UIDManager> m_uidManager;
+    // zoomed out below full detail, block content is not painted
+    bool m_lowDetail = false;
+    double m_scale = 1.0;
 };
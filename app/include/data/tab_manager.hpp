@@ -4,6 +4,8 @@
 
 #include "data/tab_components.hpp"
 
+class FdfBlockModel;
+
 class TabManager : public QObject
 {
     Q_OBJECT
@@ -17,6 +19,8 @@ public:
     }
     static UIDManager *getUIDManager()
     {
+        if (auto bound = UIDManager::bound())
+            return bound;
         return TabManager::instance().getCurrentUIDManager();
     }
 
@@ -25,6 +29,8 @@ public:
 
     std::shared_ptr<TabComponents> getCurrentTab() const;
     std::shared_ptr<TabComponents> getTab(QWidget *view) const;
+    // the tab whose graph holds the block, null for blocks outside any tab
+    std::shared_ptr<TabComponents> getTab(const FdfBlockModel *block) const;
     size_t size() const { return m_tabs.size(); }
     QWidget *currentWidget() const { return m_currentView; }
     CustomGraph *currentGraph() const;
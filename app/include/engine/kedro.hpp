@@ -5,8 +5,11 @@
 #include <QProcess>
 #include <QTemporaryDir>
 #include <QTimer>
+#include <unordered_set>
 
 class CustomGraph;
+struct GraphSnapshot;
+struct NodeSnapshot;
 
 class Kedro : public AbstractEngine
 {
@@ -23,11 +26,14 @@ private slots:
     void onTimeOut();
 
 private:
-    QString serializeNode(const QtNodes::NodeId &id, CustomGraph *graph) const;
+    QString serializeNode(const NodeSnapshot &node);
     void verifySetup();
-    bool generateParametersYml(const QDir &kedroProject, CustomGraph *graph);
-    bool generateCatalogYml(const QDir &kedroProject, std::shared_ptr<TabComponents> tab);
-    bool generatePipelinePy(const QDir &kedroProject, CustomGraph *graph);
+    // code is generated from a snapshot, the graph can be edited in the meantime
+    bool generateParametersYml(const QDir &kedroProject, const GraphSnapshot &graph);
+    bool generateCatalogYml(const QDir &kedroProject,
+                            std::shared_ptr<TabComponents> tab,
+                            const GraphSnapshot &graph);
+    bool generatePipelinePy(const QDir &kedroProject, const GraphSnapshot &graph);
     QDir ensureDirExists(const QString &path);
     void postExecutionProcess();
     void postScoreModel(CustomGraph *graph, const QtNodes::NodeId &id);
@@ -49,4 +55,8 @@ private:
     };
     std::unique_ptr<ExecutionBundle> m_execution;
     const QString m_DEFAULT_TEMPLATE;
+    // generated inner nodes of composite blocks by fingerprint, kept for the composites still
+    // in the graph at the next run
+    std::unordered_map<QString, QString> m_compositeCode;
+    std::unordered_set<QString> m_usedCompositeCode;
 };
@@ -5,8 +5,32 @@
 
 #include <QtUtility/data/qsingleton.hpp>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "mpsc_ring_buffer.hpp"
 #include "ui/log_panel.hpp"
 
+class QFile;
+class QTimer;
+
+// a queued message, the panels only get the formatted line
+struct LogRecord
+{
+    LogLine line;
+    QString message;
+    qint64 time = 0; // ms since epoch
+    // string literals of the call site, null for internal messages. Release builds only fill
+    // them because CMakeLists.txt defines QT_MESSAGELOGCONTEXT for every configuration
+    const char *file = nullptr;
+    const char *function = nullptr;
+    int lineNumber = 0;
+};
+
+// Messages are formatted on the thread logging them and queued, a logger thread writes them to
+// the log file, the JSON lines file and the console in batches, and the panels are updated at a
+// fixed rate.
 class LogManager : public QSingleton<LogManager>
 {
     Q_OBJECT
@@ -16,20 +40,51 @@ public:
     ~LogManager() override;
     void init();
     void registerLogPanel(LogPanel *panel);
-
-signals:
-    void callAppendMessage(const QString &message, const QtMsgType &type);
+    // any thread, never blocks. The message is dropped when the queue is full
+    void enqueue(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    // writes out everything queued and stops the logger thread
+    void shutdown();
+    // after a shutdown, writes the message directly instead of queueing it, for fatal messages
+    void writeFatal(const QMessageLogContext &context, const QString &message);
+    // messages lost to a full queue since startup
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    // one JSON object per line, for tools reading the logs
+    static QByteArray toJsonLine(const LogRecord &record);
 
 public slots:
     void appendMessage(const QString &message, const QtMsgType &type = QtInfoMsg);
+    void appendMessages(const std::vector<LogLine> &lines);
+
+private slots:
+    // hands the messages written since the previous tick to the panels
+    void deliverPending();
 
 private:
-    QtMessageHandler m_originalHandler;
+    LogManager();
+    // logger thread loop, writes a batch every interval
+    void run();
+    static LogRecord makeRecord(QtMsgType type,
+                                const QMessageLogContext &context,
+                                const QString &message);
+    // to the log file, the JSON lines file and the console
+    static void write(const std::vector<LogRecord> &batch, QFile &logFile, QFile &jsonFile);
+    void queueForPanels(std::vector<LogRecord> &batch);
+
+    QtMessageHandler m_originalHandler = nullptr;
     QVector<LogPanel *> m_logPanels;
-    struct LogMessage
-    {
-        QString string;
-        QColor color;
-    };
-    std::vector<LogMessage> m_notPrinted;
-};
\ No newline at end of file
+    std::vector<LogLine> m_notPrinted;
+
+    MpscRingBuffer<LogRecord> m_queue;
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    QString m_logFilePath;
+    QString m_jsonFilePath;
+    // written by the logger thread, taken by the gui thread on each tick
+    std::mutex m_pendingMutex;
+    std::vector<LogLine> m_pending;
+    quint64 m_pendingDropped = 0;
+    QTimer *m_panelTimer = nullptr;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QStringList>
+
+// One category per subsystem, named descartes.<subsystem>. Debug output is off unless enabled
+// from the settings, and compiled out entirely with QT_NO_DEBUG_OUTPUT (STRIP_DEBUG_LOGS).
+Q_DECLARE_LOGGING_CATEGORY(lcEngine)
+Q_DECLARE_LOGGING_CATEGORY(lcGraph)
+Q_DECLARE_LOGGING_CATEGORY(lcTyping)
+Q_DECLARE_LOGGING_CATEGORY(lcIo)
+Q_DECLARE_LOGGING_CATEGORY(lcUi)
+
+namespace logging {
+// subsystem names, without the descartes. prefix
+const QStringList &subsystems();
+// enables debug output for the given subsystems only
+void setDebugSubsystems(const QStringList &enabled);
+} // namespace logging
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue for many producers and a single consumer. Each cell carries a
+// sequence number telling whether it is free for the producer of that turn or filled for the
+// consumer, so a push is one compare-and-swap and a pop takes no atomic read-modify-write.
+// Pushing to a full queue fails instead of waiting.
+template<typename T>
+class MpscRingBuffer
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit MpscRingBuffer(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    MpscRingBuffer(const MpscRingBuffer &) = delete;
+    MpscRingBuffer &operator=(const MpscRingBuffer &) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // any thread, false when full
+    bool tryPush(T &&value)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = m_cells[position & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (m_head.compare_exchange_weak(position,
+                                                 position + 1,
+                                                 std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // the consumer has not freed this cell yet
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // consumer thread only, false when empty
+    bool tryPop(T &value)
+    {
+        Cell &cell = m_cells[m_tail & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_tail + 1) < 0)
+            return false;
+        value = std::move(cell.value);
+        // free for the producer one lap later
+        cell.sequence.store(m_tail + m_mask + 1, std::memory_order_release);
+        ++m_tail;
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    // producers and the consumer on separate cache lines
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) size_t m_tail = 0;
+};
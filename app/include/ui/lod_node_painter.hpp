@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QRectF>
+#include <QtNodes/DefaultNodePainter>
+
+namespace QtNodes {
+class NodeGraphicsObject;
+}
+
+// Node painter with level of detail. Zoomed out, blocks are drawn as plain boxes without ports
+// or content, which keeps panning large pipelines smooth.
+class LodNodePainter : public QtNodes::DefaultNodePainter
+{
+public:
+    // below this scale only the box and caption are drawn
+    static constexpr double FULL_DETAIL = 0.6;
+    // below this scale the caption is left out as well
+    static constexpr double CAPTION_DETAIL = 0.3;
+    // device pixels of the largest connection kept in a pixmap cache, a longer one costs more
+    // memory than drawing its path again
+    static constexpr double MAX_CACHED_CONNECTION_AREA = 512 * 512;
+
+    enum class Detail {
+        Box,
+        Caption,
+        Full,
+    };
+    static Detail detail(double levelOfDetail);
+    // whether a connection with these scene bounds is cached at the view scale
+    static bool cacheConnection(const QRectF &bounds, double scale);
+
+    void paint(QPainter *painter, QtNodes::NodeGraphicsObject &ngo) const override;
+
+private:
+    // content of the block in place of an embedded widget
+    void paintContent(QPainter *painter, QtNodes::NodeGraphicsObject &ngo) const;
+    void paintSimplified(QPainter *painter,
+                         QtNodes::NodeGraphicsObject &ngo,
+                         bool withCaption) const;
+};
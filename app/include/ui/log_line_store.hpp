@@ -0,0 +1,100 @@
+#pragma once
+
+#include <bitset>
+#include <list>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <QtMessageHandler>
+#include <vector>
+
+// one formatted message and what the panel filters it by
+struct LogLine
+{
+    QString text;
+    QtMsgType type = QtInfoMsg;
+    QString category;
+};
+
+// Append-only store for the log panel. Lines are kept in chunks, only the most recently used
+// chunks stay in memory and the others are spilled to a temporary file. Level and category of
+// every line stay in memory so filtering never touches the disk, and each chunk keeps a bloom
+// filter of its trigrams so a search skips the chunks that cannot match.
+class LogLineStore
+{
+public:
+    static constexpr size_t CHUNK_LINES = 4096;
+    // about a quarter million lines held in memory
+    static constexpr size_t RESIDENT_CHUNKS = 64;
+    static constexpr size_t NOT_FOUND = size_t(-1);
+
+    LogLineStore() = default;
+    LogLineStore(const LogLineStore &) = delete;
+    LogLineStore &operator=(const LogLineStore &) = delete;
+
+    void append(const LogLine &line);
+    size_t size() const { return m_types.size(); }
+    // loads the chunk of the line back from disk if it was spilled
+    QString text(size_t line) const;
+    QtMsgType type(size_t line) const { return static_cast<QtMsgType>(m_types.at(line)); }
+    int category(size_t line) const { return m_categories.at(line); }
+    // names in order of first appearance, indexed by category()
+    const QStringList &categories() const { return m_categoryNames; }
+    // first line from `from` on passing `accept` whose text contains the query, ignoring case
+    template<typename Accept>
+    size_t find(const QString &query, size_t from, Accept accept) const;
+    size_t residentChunks() const { return m_resident.size() + (m_chunks.empty() ? 0 : 1); }
+    // chunks read back from the spill file so far
+    size_t loads() const { return m_loads; }
+
+private:
+    // a chunk holds some ten thousand distinct trigrams, about ten bits each with three hashes
+    // keeps false positives under one percent per trigram, so a search rarely loads a chunk
+    // that cannot match
+    static constexpr size_t BLOOM_BITS = 1 << 17;
+    static constexpr size_t BLOOM_HASHES = 3;
+    using Bloom = std::bitset<BLOOM_BITS>;
+    struct Chunk
+    {
+        // empty while spilled
+        std::vector<QString> lines;
+        // where the chunk was written, -1 if never spilled
+        qint64 fileOffset = -1;
+        Bloom trigrams;
+    };
+
+    static void addTrigrams(Bloom &bloom, const QString &text);
+    bool mayContain(size_t chunk, const QString &query) const;
+    // keeps the chunk in memory as most recently used, spilling the least recently used
+    void touch(size_t chunk) const;
+    void spill(size_t chunk) const;
+    void load(size_t chunk) const;
+
+    mutable std::vector<Chunk> m_chunks;
+    std::vector<quint8> m_types;
+    std::vector<quint16> m_categories;
+    QStringList m_categoryNames;
+    // full chunks in memory, most recently used first. The chunk being filled is not in it
+    mutable std::list<size_t> m_resident;
+    mutable QTemporaryFile m_spillFile;
+    mutable size_t m_loads = 0;
+};
+
+template<typename Accept>
+size_t LogLineStore::find(const QString &query, size_t from, Accept accept) const
+{
+    if (query.isEmpty())
+        return NOT_FOUND;
+    auto lowered = query.toLower();
+    for (size_t line = from; line < size();) {
+        size_t chunk = line / CHUNK_LINES;
+        size_t chunkEnd = std::min(size(), (chunk + 1) * CHUNK_LINES);
+        if (!mayContain(chunk, lowered)) {
+            line = chunkEnd;
+            continue;
+        }
+        for (; line < chunkEnd; ++line)
+            if (accept(line) && text(line).contains(query, Qt::CaseInsensitive))
+                return line;
+    }
+    return NOT_FOUND;
+}
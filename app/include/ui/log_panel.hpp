@@ -1,16 +1,75 @@
 #pragma once
 
+#include <QAbstractListModel>
 #include <QColor>
-#include <QPlainTextEdit>
+#include <QSet>
+#include <QWidget>
 
-class LogPanel : public QPlainTextEdit
+#include "ui/log_line_store.hpp"
+
+class QComboBox;
+class QLineEdit;
+class QListView;
+class QTimer;
+
+// list model over the log store, only the lines passing the level and category filters are rows
+class LogListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    LogListModel(QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void append(const std::vector<LogLine> &lines);
+    const LogLineStore &store() const { return m_store; }
+    // lines less severe than the level are hidden, QtDebugMsg shows all
+    void setMinimumLevel(QtMsgType level);
+    // empty shows all categories
+    void setCategory(const QString &category);
+    bool accepts(size_t line) const;
+    size_t lineAt(int row) const;
+    // row of the line or of the first visible line after it
+    int rowOf(size_t line) const;
+
+signals:
+    void categoryAdded(const QString &category);
+
+private:
+    // same as accepts(size_t) for a line not in the store yet
+    bool accepts(const LogLine &line) const;
+    void refilter();
+
+    LogLineStore m_store;
+    int m_minimumSeverity = 0;
+    int m_category = -1;
+    // visible lines in order, unused while nothing is filtered
+    std::vector<size_t> m_rows;
+    bool m_filtered = false;
+};
+
+// Log panel over a virtual list, only the visible rows are ever laid out
+class LogPanel : public QWidget
 {
     Q_OBJECT
 public:
     LogPanel(QWidget *parent = nullptr);
 
-    void appendMessage(const QString &text, const QColor &color = QColor());
+    void appendMessage(const QString &text, QtMsgType type = QtInfoMsg);
+    void appendMessages(const std::vector<LogLine> &lines);
+
+private slots:
+    void findNext();
 
 private:
-    const QColor m_DEFAULT_TEXT_COLOR;
-};
\ No newline at end of file
+    // selects the first visible match from the line on, wrapping around once
+    void find(size_t from);
+
+    LogListModel *m_model;
+    QListView *m_view;
+    QComboBox *m_levelBox;
+    QComboBox *m_categoryBox;
+    QLineEdit *m_searchEdit;
+    // search as you type waits for a pause in typing
+    QTimer *m_searchTimer;
+};
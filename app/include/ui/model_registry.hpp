@@ -3,6 +3,7 @@
 #include <QtNodes/NodeDelegateModelRegistry>
 
 #include "ui/models/coder_models.hpp"
+#include "ui/models/composite_model.hpp"
 #include "ui/models/io_models.hpp"
 #include "ui/models/processor_models.hpp"
 #include "ui/models/trainer_models.hpp"
@@ -25,6 +26,9 @@ static std::shared_ptr<QtNodes::NodeDelegateModelRegistry> registerDataModels()
     ret->registerModel<ReduceDataModel>("Coder");
     ret->registerModel<BasicTrainerModel>("Trainer");
     ret->registerModel<TorchTrainerModel>("Trainer");
+    ret->registerModel<CompositeModel>("Composite");
+    ret->registerModel<CompositeInputModel>("Composite");
+    ret->registerModel<CompositeOutputModel>("Composite");
 
     return ret;
 }
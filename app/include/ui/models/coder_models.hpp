@@ -17,9 +17,9 @@ public:
     inline static const QString RANDOM_STATE = "random_state";
 
     CoderModel(const QString &name, const QString &functionName);
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const override;
+    virtual ParameterSchema getParameterSchema() const override;
     virtual bool portNumberModifiable(const PortType &portType) const override;
-    virtual uint minModifiablePorts(const PortType &portType, const QString &typeId) const override;
+    virtual uint minModifiablePorts(const PortType &portType, PortKind kind) const override;
     virtual std::vector<FdfUID> fetchOrCreateOutputType(const std::vector<FdfUID> &inputTypeIds) = 0;
 
 protected:
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "fdf_block_model.hpp"
+
+#include <QJsonObject>
+
+#include <QtUtility/data/constexpr_qstring.hpp>
+
+class CustomGraph;
+struct GraphSnapshot;
+
+namespace composite_names {
+using ConstLatin1String = QtUtility::data::ConstLatin1String;
+constexpr ConstLatin1String COMPOSITE = "composite";
+constexpr ConstLatin1String INPUT = "composite_input";
+constexpr ConstLatin1String OUTPUT = "composite_output";
+} // namespace composite_names
+
+// data entering a sub-pipeline, one per in port of the composite block
+class CompositeInputModel : public FdfBlockModel
+{
+    Q_OBJECT
+public:
+    CompositeInputModel();
+};
+
+// data leaving a sub-pipeline, one per out port of the composite block
+class CompositeOutputModel : public FdfBlockModel
+{
+    Q_OBJECT
+public:
+    CompositeOutputModel();
+};
+
+// Block holding a sub-pipeline, the boundary blocks inside become its ports. The sub-graph is
+// kept as json and only built when the block is expanded, so large pipelines don't pay for the
+// blocks hidden in composites. Codegen emits it as a kedro modular pipeline.
+class CompositeModel : public FdfBlockModel
+{
+    Q_OBJECT
+public:
+    CompositeModel();
+    ~CompositeModel();
+    QJsonObject save() const override;
+    void load(QJsonObject const &p) override;
+    QStringList validityIssues() const override;
+
+    // the sub-pipeline as saved by the graph, taken from the sub-graph while expanded
+    QJsonObject pipeline() const;
+    void setPipeline(const QJsonObject &pipeline);
+    // the graph holding the block, edited sub-graphs share its interner and uid manager
+    void setParentGraph(CustomGraph *graph) { m_parentGraph = graph; }
+    // takes over a graph built elsewhere, e.g. when grouping blocks
+    void setSubGraph(std::unique_ptr<CustomGraph> graph);
+    // builds the sub-graph for editing, the same graph is returned until collapsed
+    CustomGraph *expand();
+    void collapse();
+    bool isExpanded() const { return m_subGraph != nullptr; }
+    // hash of the sub-pipeline, equal fingerprints generate the same code
+    QString fingerprint() const;
+    // snapshot of the sub-pipeline, built once per fingerprint when the block is collapsed
+    std::shared_ptr<const GraphSnapshot> pipelineSnapshot() const;
+
+public slots:
+    void onDataInputSet(const PortIndex &index) override;
+
+private:
+    void connectSubGraph();
+    void updatePorts();
+    void updateOutputTypes();
+    // boundary blocks of the sub-pipeline and their captions, in port order
+    std::vector<std::pair<QtNodes::NodeId, QString>> boundaryNodes(const QString &name) const;
+    // type ids of an edited sub-graph cross the block's ports, a graph only built for a
+    // snapshot keeps its types to its own uid manager instead
+    std::unique_ptr<CustomGraph> makeSubGraph(bool edited) const;
+
+    QJsonObject m_pipeline;
+    CustomGraph *m_parentGraph = nullptr;
+    std::unique_ptr<CustomGraph> m_subGraph;
+    mutable QString m_fingerprint;
+    mutable std::shared_ptr<const GraphSnapshot> m_snapshot;
+    mutable QString m_snapshotFingerprint;
+};
@@ -1,8 +1,7 @@
 #pragma once
 
-#include <QLabel>
+#include <array>
 #include <QObject>
-#include <QPointer>
 #include <QtNodes/NodeDelegateModel>
 using QtNodes::ConnectionId;
 using QtNodes::NodeDelegateModel;
@@ -10,8 +9,38 @@ using QtNodes::NodeShape;
 using QtNodes::PortIndex;
 using QtNodes::PortType;
 
+#include "logging_categories.hpp"
 #include "ui/models/nodes.hpp"
 
+class QPainter;
+
+// one parameter of a block type, declared in static tables shared by all blocks of the type
+struct ParameterDescriptor
+{
+    const QString *key; // the key constant declared by the model
+    QMetaType::Type type;
+};
+
+// view over a static descriptor table, passing it around does not allocate
+class ParameterSchema
+{
+public:
+    constexpr ParameterSchema() = default;
+    template<size_t N>
+    constexpr ParameterSchema(const ParameterDescriptor (&table)[N])
+        : m_begin(table)
+        , m_end(table + N)
+    {}
+    const ParameterDescriptor *begin() const { return m_begin; }
+    const ParameterDescriptor *end() const { return m_end; }
+    bool empty() const { return m_begin == m_end; }
+    size_t size() const { return m_end - m_begin; }
+
+private:
+    const ParameterDescriptor *m_begin = nullptr;
+    const ParameterDescriptor *m_end = nullptr;
+};
+
 class FdfBlockModel : public NodeDelegateModel
 {
     Q_OBJECT
@@ -31,14 +60,15 @@ public:
     NodeShape shape() const override { return m_shape; }
     QString functionName() const { return m_functionName; }
     QString caption() const override { return m_caption; }
-    virtual bool hasParameters() const { return getParameters().size() > 0; }
+    virtual bool hasParameters() const { return !getParameterSchema().empty(); }
     unsigned int nPorts(PortType const portType) const override;
     bool hasDataOutPorts();
     bool hasFunctionOutPorts();
     NodeDataType dataType(PortType const portType, PortIndex const portIndex) const override;
     std::shared_ptr<NodeData> outData(PortIndex const index) override;
     virtual void setInData(std::shared_ptr<NodeData> data, PortIndex const index) override;
-    virtual QWidget *embeddedWidget() override;
+    // blocks paint their content instead of embedding widgets, see paintContent
+    virtual QWidget *embeddedWidget() override { return nullptr; }
     QString portCaption(PortType portType, PortIndex portIndex) const override;
     QString defaultPortCaption(PortType portType, PortIndex portIndex) const;
     QJsonObject save() const override;
@@ -55,15 +85,21 @@ public:
                                  const QString &annot);
     bool resetPortCaption(PortType portType, PortIndex portIndex);
     void propagateUpdate();
-    virtual bool checkBlockValidity() const;
+    // everything preventing the block from running, empty when the block is valid
+    virtual QStringList validityIssues() const;
+    // outline the block with the error colour of the node style
+    void setInvalidHighlight(bool invalid);
 
     virtual std::shared_ptr<NodeData> inData(PortIndex const index);
     virtual std::unordered_map<QString, QString> getParameters() const;
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const;
+    // the parameters of the block type in display order, values come from getParameters
+    virtual ParameterSchema getParameterSchema() const;
     virtual QStringList getParameterOptions(const QString &key) const;
     virtual void setParameter(const QString &key, const QString &value);
-    uint nPorts(const PortType &portType, const QString &typeId) const;
-    virtual uint minModifiablePorts(const PortType &portType, const QString &typeId) const;
+    // sets the parameter and lets the graph know it changed
+    void updateParameter(const QString &key, const QString &value);
+    uint nPorts(const PortType &portType, PortKind kind) const;
+    virtual uint minModifiablePorts(const PortType &portType, PortKind kind) const;
     virtual bool portNumberModifiable(const PortType &portType) const { return false; };
 
     std::unordered_map<QString, QString> getExecutedValues() const { return m_executedValues; }
@@ -71,23 +107,63 @@ public:
     QStringList getExecutedGraphs() const { return m_executedGraphs; }
     void setExecutedGraphs(const QStringList &paths);
     virtual bool canConnect(ConnectionInfo &connInfo) const;
+    // checks shared by all blocks, then the block specific canConnect
+    bool verifyConnection(ConnectionInfo &connInfo) const;
+    // quick check while a connection is dragged over the in port, must not allocate or ask
+    // the user. Only rejects what verifyConnection would reject without a way to override
+    virtual bool acceptsConnection(const PortDescriptor &source, PortIndex inIndex) const;
+    PortDescriptor outPortDescriptor(PortIndex index) const;
+    PortKind kindAt(PortType type, PortIndex index) const;
+    // whether the block can stream through chunked data inputs with bounded memory
+    virtual bool acceptsChunkedInput() const { return false; }
+    bool hasChunkedInput() const;
+    // the graph node this block is the delegate of, stamped on the out ports
+    NodeId nodeId() const { return m_nodeId; }
+    void setNodeId(const NodeId &id);
+    PortIndex outPortIndex(const NodeData *port) const;
+    // space kept below the ports for content painted by the block, empty for none
+    virtual QSize contentSize() const { return QSize(); }
+    // where the content goes in a block of the given size
+    QRectF contentRect(const QSizeF &blockSize) const;
+    virtual void paintContent(QPainter *painter, const QRectF &rect) const {}
+    // mouse press on the content, position relative to its top left. Returns true if handled
+    virtual bool contentPressed(const QPointF &position, const QSizeF &size) { return false; }
+    static constexpr int CONTENT_MARGIN = 6;
 
     template<typename T>
     std::vector<std::shared_ptr<T>> allOutData()
     {
-        static_assert(std::is_base_of<NodeData, T>::value, "T must derive from NodeData");
+        static_assert(std::is_base_of<NamedNode, T>::value, "T must derive from NamedNode");
         std::vector<std::shared_ptr<T>> result;
-        for (auto &pair : m_outPorts)
-            if (auto casted = std::dynamic_pointer_cast<T>(pair.first))
-                result.push_back(casted);
+        if constexpr (isPortKind<T>()) {
+            for (const auto &index : m_outPortsByKind[portKind<T>()])
+                result.push_back(std::static_pointer_cast<T>(m_outPorts[index].data));
+        } else {
+            for (auto &port : m_outPorts)
+                result.push_back(std::static_pointer_cast<T>(port.data));
+        }
         return result;
     }
+    // the out port at index if it holds a T, decided by the port kind
+    template<typename T>
+    std::shared_ptr<T> outPort(PortIndex index) const
+    {
+        static_assert(std::is_base_of<NamedNode, T>::value, "T must derive from NamedNode");
+        if (!indexCheck(PortType::Out, index) || !hasKind<T>(m_outPorts[index].kind))
+            return nullptr;
+        return std::static_pointer_cast<T>(m_outPorts[index].data);
+    }
 
 signals:
     void captionUpdated(const QString &caption);
     void outPortCaptionUpdated(const PortIndex &index, const QString &caption);
     void outPortInserted(const PortIndex &index);
     void outPortDeleted(const PortIndex &index);
+    // the outputs changed, the graph schedules pushing them downstream
+    void propagationRequested();
+    void parameterUpdated(const QString &key);
+    // the painted content changed, the block is resized and repainted
+    void paintedContentUpdated();
 
 public slots:
     virtual void outputConnectionCreated(ConnectionId const &conn) override;
@@ -101,20 +177,42 @@ public slots:
 
 protected:
     bool indexCheck(PortType type, PortIndex index) const;
+    // DataNode and FunctionNode are tagged with their kind, NamedNode matches both
+    template<typename T>
+    static constexpr bool isPortKind()
+    {
+        return std::is_same<T, DataNode>::value || std::is_same<T, FunctionNode>::value;
+    }
+    template<typename T>
+    static constexpr PortKind portKind()
+    {
+        static_assert(isPortKind<T>(), "T must be DataNode or FunctionNode");
+        return std::is_same<T, FunctionNode>::value ? FunctionPort : DataPort;
+    }
+    template<typename T>
+    static constexpr bool hasKind(PortKind kind)
+    {
+        if constexpr (isPortKind<T>())
+            return kind == portKind<T>();
+        else
+            return std::is_base_of<T, NamedNode>::value;
+    }
     template<typename T>
     void addPort(PortType type, const QString &name = QString())
     {
-        static_assert(std::is_base_of<NodeData, T>::value, "T must derive from NodeData");
         int index = type == PortType::In ? m_inPorts.size() : m_outPorts.size();
         emit portsAboutToBeInserted(type, index, index);
         if (type == PortType::In) {
             auto port = name.isEmpty() ? std::make_unique<T>() : std::make_unique<T>(name);
-            m_inPorts.push_back({std::move(port), std::weak_ptr<NodeData>()});
+            m_inPorts.push_back({std::move(port), std::weak_ptr<NodeData>(), portKind<T>()});
+            m_inPortsByKind[portKind<T>()].push_back(index);
         } else if (type == PortType::Out) {
             auto port = name.isEmpty() ? std::make_shared<T>() : std::make_shared<T>(name);
-            m_outPorts.push_back({port, false});
+            port->setOwnerId(m_nodeId);
+            m_outPorts.push_back({port, false, portKind<T>()});
+            m_outPortsByKind[portKind<T>()].push_back(index);
         } else {
-            qCritical() << "Unhandled type";
+            qCCritical(lcTyping) << "Unhandled type";
             return;
         }
         emit portsInserted();
@@ -122,40 +220,34 @@ protected:
             emit outPortInserted(index);
         emit contentUpdated();
     }
+    // removes the last port of type T, there might be both kinds in the same side
     template<typename T>
     void removePort(PortType type)
     {
-        static_assert(std::is_base_of<NodeData, T>::value, "T must derive from NodeData");
-        int index = (type == PortType::In ? m_inPorts.size() : m_outPorts.size()) - 1;
-        emit portsAboutToBeDeleted(type, index, index);
-        if (type == PortType::In) {
-            removePort<T, InPortType>(m_inPorts);
-        } else if (type == PortType::Out) {
-            removePort<T, OutPortType>(m_outPorts);
-        } else {
-            qCritical() << "Unhandled type";
+        if (type != PortType::In && type != PortType::Out) {
+            qCCritical(lcTyping) << "Unhandled type";
             return;
         }
+        auto &indices = (type == PortType::In ? m_inPortsByKind
+                                               : m_outPortsByKind)[portKind<T>()];
+        if (indices.empty())
+            return;
+        PortIndex index = indices.back();
+        emit portsAboutToBeDeleted(type, index, index);
+        if (type == PortType::In)
+            m_inPorts.erase(m_inPorts.begin() + index);
+        else
+            m_outPorts.erase(m_outPorts.begin() + index);
+        updatePortKindIndices(type);
         emit portsDeleted();
         if (type == PortType::Out)
             emit outPortDeleted(index);
         emit contentUpdated();
     }
-    template<typename NodeData, typename PortType>
-    void removePort(PortType &ports)
-    {
-        for (int i = ports.size() - 1; i >= 0; --i)
-            // check whether we are removing port of type T (Data, Function etc.), we might have both types together in "ports"
-            if (dynamic_cast<NodeData *>(ports[i].first.get())) {
-                ports.erase(ports.begin() + i);
-                break;
-            }
-    }
     template<typename T>
     void setPortNumber(PortType type, uint num)
     {
-        static_assert(std::is_base_of<NodeData, T>::value, "T must derive from NodeData");
-        uint current = nPorts(type, constants::DATA_PORT_ID);
+        uint current = nPorts(type, portKind<T>());
         if (current > num)
             for (int i = 0; i < current - num; ++i)
                 removePort<T>(type);
@@ -166,13 +258,13 @@ protected:
     template<typename T>
     std::shared_ptr<T> castedPort(PortType type, PortIndex index)
     {
-        static_assert(std::is_base_of<NodeData, T>::value, "T must derive from NodeData");
+        static_assert(std::is_base_of<NamedNode, T>::value, "T must derive from NamedNode");
         if (type == PortType::In) {
-            if (auto shared = std::dynamic_pointer_cast<T>(m_inPorts.at(index).second.lock()))
-                return shared;
+            // checked, the connected data is whatever the other block sent
+            if (indexCheck(type, index) && hasKind<T>(m_inPorts[index].kind))
+                return std::dynamic_pointer_cast<T>(m_inPorts[index].connected.lock());
         } else if (type == PortType::Out) {
-            if (auto shared = std::dynamic_pointer_cast<T>(m_outPorts.at(index).first))
-                return shared;
+            return outPort<T>(index);
         }
         return nullptr;
     }
@@ -180,22 +272,35 @@ protected:
     template<typename T>
     T *getInputPortAt(std::size_t index) const
     {
-        if (index >= m_inPorts.size() || !m_inPorts[index].first) {
+        if (index >= m_inPorts.size() || !m_inPorts[index].structure
+            || !hasKind<T>(m_inPorts[index].kind)) {
             return nullptr;
         }
-        return dynamic_cast<T *>(m_inPorts[index].first.get());
+        return static_cast<T *>(m_inPorts[index].structure.get());
     }
     // show warning for invalid port connection (implicit typing failure)
     bool warnInvalidConnection(ConnectionInfo connInfo, const QString &message) const;
+    // set the chunked state of the data out ports
+    void setOutputChunked(bool chunked);
     Q_INVOKABLE bool showWarning(ConnectionInfo connInfo, const QString &message);
     std::vector<QString> m_defaultTags;  // default tags to be used as placeholder
     std::vector<QString> m_defaultAnnot; // default annotations to be used as placeholder
 
 private:
-    using InPortType = std::vector<std::pair<std::unique_ptr<NodeData>, std::weak_ptr<NodeData>>>;
-    // port -> in use
-    using OutPortType = std::vector<std::pair<std::shared_ptr<NodeData>, bool>>;
+    struct InPort
+    {
+        std::unique_ptr<NamedNode> structure; // for structuring
+        std::weak_ptr<NodeData> connected;    // actual data linked to connected block
+        PortKind kind;
+    };
+    struct OutPort
+    {
+        std::shared_ptr<NamedNode> data;
+        bool inUse;
+        PortKind kind;
+    };
 
+    void updatePortKindIndices(PortType type);
     void updateStyle();
     void updateShape();
 
@@ -214,11 +319,12 @@ private:
     QString m_functionName;
     // caption is the label of the block, we regard this as the "name" for kedro
     QString m_caption;
-    // first is for structuring, second is actual data linked to connected block
-    InPortType m_inPorts;
-    // first is for data, second represents whether it's in use
-    OutPortType m_outPorts;
+    std::vector<InPort> m_inPorts;
+    std::vector<OutPort> m_outPorts;
+    // indices of the ports of each kind, in port order
+    std::array<std::vector<PortIndex>, 2> m_inPortsByKind;
+    std::array<std::vector<PortIndex>, 2> m_outPortsByKind;
     std::unordered_map<QString, QString> m_executedValues;
     QStringList m_executedGraphs;
-    QPointer<QLabel> m_label; // For block resize
+    NodeId m_nodeId = QtNodes::InvalidNodeId;
 };
@@ -1,14 +1,13 @@
 #pragma once
 
+#include "data/h5_browser.hpp"
 #include "fdf_block_model.hpp"
 
 #include <QFileInfo>
+#include <QPixmap>
 
 #include <QtUtility/data/constexpr_qstring.hpp>
 
-class QWidget;
-class QLabel;
-
 namespace io_names {
 using ConstLatin1String = QtUtility::data::ConstLatin1String;
 constexpr ConstLatin1String DATA_SOURCE = "data_source";
@@ -17,14 +16,20 @@ constexpr ConstLatin1String DATA_OUT = "data_out";
 constexpr ConstLatin1String GRAPH_FUNCTION = "graph_function";
 } // namespace io_names
 
-enum CatalogType { Pickle, Csv, H5 };
+enum CatalogType { Pickle, Csv, H5, Parquet, Feather };
+enum Codec { Uncompressed, Lz4, Zstd };
 
 class DataSourceModel : public FdfBlockModel
 {
     Q_OBJECT
 public:
+    inline static const QString CHUNK_SIZE = "chunk_size";
+    inline static const QString DATASET = "dataset";
+    inline static const QString ROWS = "rows";
     DataSourceModel();
-    QWidget *embeddedWidget() override;
+    QSize contentSize() const override;
+    void paintContent(QPainter *painter, const QRectF &rect) const override;
+    bool contentPressed(const QPointF &position, const QSizeF &size) override;
     QJsonObject save() const override;
     void load(QJsonObject const &p) override;
     QFileInfo file() const { return m_file; }
@@ -33,48 +38,94 @@ public:
     void setFile(const QFileInfo &file);
     static QString fileFilter();
     QString outPortCaption();
-    bool checkBlockValidity() const override;
+    QStringList validityIssues() const override;
+    virtual std::unordered_map<QString, QString> getParameters() const override;
+    virtual ParameterSchema getParameterSchema() const override;
+    virtual QStringList getParameterOptions(const QString &key) const override;
+    virtual void setParameter(const QString &key, const QString &value) override;
+    int chunkSize() const { return m_chunkSize; }
+    void setChunkSize(int chunkSize);
+    // only csv and h5 files can be read as an iterator of row blocks
+    bool supportsChunking() const;
+    bool isChunked() const { return m_chunkSize > 0 && supportsChunking(); }
+    // arguments passed to the dataset when it is loaded, in catalog order
+    std::vector<std::pair<QString, QString>> loadArgs() const;
+    // datasets of an h5 source, browsed once per file
+    const std::vector<data::H5DatasetInfo> &h5Datasets() const;
+    // selected h5 dataset, empty loads the whole file
+    QString h5Dataset() const { return m_h5Dataset; }
+    void setH5Dataset(const QString &path);
+    // selected range along the first axis, "start:stop" with either bound optional
+    QString h5Rows() const { return m_h5Rows; }
+    void setH5Rows(const QString &rows) { m_h5Rows = rows.trimmed(); }
 
 signals:
     void importClicked();
 
 private:
-    QWidget *m_widget;
-    QLabel *m_label;
+    void updateChunking();
+
+    QString absoluteFilePath() const;
+
+    inline static const QString ALL_DATASETS = "(all)";
 
     // not the actual file path, using it for relative path
     QFileInfo m_file;
     std::optional<CatalogType> m_fileType;
+    // rows per chunk, 0 loads the whole file at once
+    int m_chunkSize = 0;
+    QString m_h5Dataset;
+    QString m_h5Rows;
+    mutable std::optional<std::vector<data::H5DatasetInfo>> m_h5Datasets;
 };
 
-class FuncOutModel : public FdfBlockModel
+// Common base of the blocks that persist a kedro output to the catalog
+class OutputModel : public FdfBlockModel
 {
     Q_OBJECT
 public:
-    FuncOutModel();
+    inline static const QString FILE_TYPE = "file_type";
+    inline static const QString CODEC = "codec";
+    inline static const QString COMPRESSION_LEVEL = "compression_level";
+    OutputModel(const QString &name, const std::vector<CatalogType> &supportedTypes);
     CatalogType getFileType() const { return m_fileType; }
     QString fileTypeString() const;
-    void setFileType(const CatalogType &fileType) { m_fileType = fileType; }
+    void setFileType(const CatalogType &fileType);
     QString getFileName() const;
     QString getFileExtenstion() const;
+    Codec getCodec() const { return m_codec; }
+    QString codecString() const;
+    // the level is clamped to the range of the new codec
+    void setCodec(const Codec &codec);
+    int getCompressionLevel() const { return m_compressionLevel; }
+    // clamped to the levels the codec accepts, kept as is while uncompressed
+    void setCompressionLevel(int level);
+    virtual std::unordered_map<QString, QString> getParameters() const override;
+    virtual ParameterSchema getParameterSchema() const override;
+    virtual QStringList getParameterOptions(const QString &key) const override;
+    virtual void setParameter(const QString &key, const QString &value) override;
 
 private:
+    // catalog types the block can be written as
+    std::vector<CatalogType> m_supportedTypes;
     CatalogType m_fileType;
+    Codec m_codec = Codec::Uncompressed;
+    // only honoured by parquet and feather, pickles use the codec default
+    int m_compressionLevel = 3;
 };
 
-class DataOutModel : public FdfBlockModel
+class FuncOutModel : public OutputModel
 {
     Q_OBJECT
 public:
-    DataOutModel();
-    CatalogType getFileType() const { return m_fileType; }
-    QString fileTypeString() const;
-    void setFileType(const CatalogType &fileType) { m_fileType = fileType; }
-    QString getFileName() const;
-    QString getFileExtenstion() const;
+    FuncOutModel();
+};
 
-private:
-    CatalogType m_fileType;
+class DataOutModel : public OutputModel
+{
+    Q_OBJECT
+public:
+    DataOutModel();
 };
 
 class GraphModel : public FdfBlockModel
@@ -84,11 +135,13 @@ public:
     GraphModel();
     QFileInfo file() const { return m_file; }
     void setFile(const QFileInfo &file);
-    QWidget *embeddedWidget() override;
+    QSize contentSize() const override;
+    void paintContent(QPainter *painter, const QRectF &rect) const override;
 
 private:
     void updateGraph();
 
-    QLabel *m_graph;
+    // graph image already scaled down to the content size
+    QPixmap m_graph;
     QFileInfo m_file;
 };
\ No newline at end of file
@@ -8,14 +8,45 @@
 using QtNodes::NodeData;
 using QtNodes::NodeDataType;
 
+// what a port carries
+enum PortKind {
+    DataPort,
+    FunctionPort,
+};
+
+// the typing of an out port in a few plain values, cheap to build and compare while the
+// user drags a connection
+struct PortDescriptor
+{
+    PortKind kind;
+    FdfUID typeId = UIDManager::NONE_ID;
+    SignatureId signature = SignatureTable::EMPTY_ID;
+    bool chunked = false;
+    // inputs and outputs of the signature, handles are only comparable within one project
+    std::pair<size_t, size_t> arity{0, 0};
+};
+
 class NamedNode : public NodeData
 {
 public:
+    // how the output of a port is handed to the connected blocks by kedro
+    enum Persistence {
+        Default, // not declared in the catalog, kedro decides
+        Memory,
+        Pickle,
+        Parquet,
+        CompressedPickle,
+    };
+
     NamedNode(const QString &name)
         : m_defaultName(
               name) // TODO : Verify and remove m_defaultName. All calls accessing this attribute have been removed
         , m_type({"NamedNode", name})
+        , m_persistence(Persistence::Default)
     {}
+    ~NamedNode();
+    NamedNode(const NamedNode &) = delete;
+    NamedNode &operator=(const NamedNode &) = delete;
 
     virtual QString id() { return m_type.id; }
     QString name() const { return m_type.name; }
@@ -26,10 +57,29 @@ public:
     void setDefaultName(const QString &name) { m_defaultName = constants::sanitizeCaption(name); }
     void reset() { m_type.name = m_defaultName; }
     NodeDataType type() const override { return m_type; }
+    Persistence persistence() const { return m_persistence; }
+    void setPersistence(const Persistence &persistence) { m_persistence = persistence; }
+    QString persistenceString() const;
+    bool setPersistence(const QString &persistence);
+    // persistence policies that make sense for this kind of port
+    virtual QStringList persistenceOptions() const;
+    virtual PortDescriptor descriptor() const = 0;
+    // the block this port is an output of, set once the block is part of a graph
+    NodeId ownerId() const { return m_ownerId; }
+    void setOwnerId(const NodeId &id) { m_ownerId = id; }
 
 protected:
+    // the uid manager of the graph building this port, bound on first use. Every lookup of the
+    // port goes through it so tags and the type index never come from different managers
+    UIDManager *indexManager();
+
     QString m_defaultName;
     NodeDataType m_type;
+    Persistence m_persistence;
+    NodeId m_ownerId = QtNodes::InvalidNodeId;
+    UIDManager *m_uidManager = nullptr;
+
+    friend class UIDManager;
 };
 
 class DataNode : public NamedNode
@@ -38,6 +88,7 @@ public:
     DataNode();
     DataNode(const QString &name);
     DataNode(FdfUID typeId);
+    ~DataNode();
 
     FdfUID typeId() const;
     void setTypeId(const FdfUID &typeId);
@@ -47,12 +98,22 @@ public:
     QString annotation() const;
     void updateDisplayName();
     void setPlaceHolderCaption(QString typeTag, QString annot);
+    QStringList persistenceOptions() const override;
+    PortDescriptor descriptor() const override
+    {
+        return {DataPort, m_typeId, SignatureTable::EMPTY_ID, m_chunked};
+    }
+    // a chunked port hands over an iterator of row blocks instead of the whole dataset
+    bool isChunked() const { return m_chunked; }
+    void setChunked(bool chunked) { m_chunked = chunked; }
 
 private:
     FdfUID m_typeId;
     QString m_typeTagName;
     QString m_annotation;
+    bool m_chunked = false;
     void setParams(const QString &name);
+    void reindex(FdfUID previous);
 };
 
 class FunctionNode : public NamedNode
@@ -60,10 +121,18 @@ class FunctionNode : public NamedNode
 public:
     FunctionNode();
     FunctionNode(const QString &name);
+    ~FunctionNode();
 
-    Signature signature() const;
+    const Signature &signature() const;
+    SignatureId signatureId() const { return m_signatureId; }
     void setSignature(const Signature &signature);
+    PortDescriptor descriptor() const override
+    {
+        return {FunctionPort, UIDManager::NONE_ID, m_signatureId, false, signature().size()};
+    }
 
 private:
-    Signature m_signature;
+    void unindex();
+
+    SignatureId m_signatureId = SignatureTable::EMPTY_ID;
 };
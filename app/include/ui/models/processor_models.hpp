@@ -9,7 +9,7 @@ class ProcessorModel : public FdfBlockModel
 public:
     ProcessorModel(const QString &name, const QString &functionName);
     virtual bool portNumberModifiable(const PortType &portType) const override;
-    virtual uint minModifiablePorts(const PortType &portType, const QString &typeId) const override;
+    virtual uint minModifiablePorts(const PortType &portType, PortKind kind) const override;
 
 public slots:
     virtual void setInputPortNumber(uint num) override;
@@ -20,6 +20,9 @@ class SplitDataModel : public ProcessorModel
 {
     Q_OBJECT
 public:
+    inline static const QString RANDOM_STATE = "random_state";
+    inline static const QString SPLIT_TIME = "split_time";
+    inline static const QString TRAIN_SIZE = "train_size";
     /**
     * @brief Constructs the SplitDataModel object.
     * 
@@ -34,7 +37,7 @@ public:
     // need to be true even if parameters is empty
     virtual bool hasParameters() const override { return true; }
     virtual std::unordered_map<QString, QString> getParameters() const override;
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const override;
+    virtual ParameterSchema getParameterSchema() const override;
     virtual void setParameter(const QString &key, const QString &value) override;
     std::optional<int> getRandomState() const { return m_randomState; }
     std::optional<int> getSplitTime() const { return m_splitTime; }
@@ -50,9 +53,6 @@ public slots:
 private:
     // define the output type for a given input type
     void setOutputType(const PortIndex &inputIndex, const FdfUID &typeId);
-    inline static const QString RANDOM_STATE = "random_state";
-    inline static const QString SPLIT_TIME = "split_time";
-    inline static const QString TRAIN_SIZE = "train_size";
 
     std::optional<int> m_randomState;
     std::optional<int> m_splitTime = 0;
@@ -89,6 +89,7 @@ class ScoreModel : public ProcessorModel
 {
     Q_OBJECT
 public:
+    inline static const QString PLOT = "plot";
     enum Plot {
         Regression,
         TimeSeries,
@@ -102,17 +103,18 @@ public:
  */
     ScoreModel();
     virtual std::unordered_map<QString, QString> getParameters() const override;
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const override;
+    virtual ParameterSchema getParameterSchema() const override;
     virtual QStringList getParameterOptions(const QString &key) const override;
     virtual void setParameter(const QString &key, const QString &value) override;
     virtual bool canConnect(ConnectionInfo &connInfo) const override;
+    // the scores are accumulated over the chunks
+    virtual bool acceptsChunkedInput() const override { return true; }
     virtual void onDataInputReset(const PortIndex &index) override;
 
     std::optional<Plot> getPlot() const { return m_plot; }
     void setPlot(const std::optional<Plot> &plot) { m_plot = plot; }
 
 private:
-    inline static const QString PLOT = "plot";
     // TODO get rid of this funky optionals..
     std::optional<Plot> m_plot;
 };
@@ -121,6 +123,10 @@ class SensitivityAnalysisModel : public ProcessorModel
 {
     Q_OBJECT
 public:
+    inline static const QString NUM_SAMPLE = "num_sample";
+    inline static const QString TARGET = "target";
+    inline static const QString DIFF_STEP = "diff_step";
+    inline static const QString GRID_SIZE = "grid_size";
     /**
  * @brief Constructs the SensitivityAnalysisModel object.
  * 
@@ -132,20 +138,17 @@ public:
 
     virtual bool hasParameters() const override { return true; }
     virtual std::unordered_map<QString, QString> getParameters() const override;
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const override;
+    virtual ParameterSchema getParameterSchema() const override;
     virtual void setParameter(const QString &key, const QString &value) override;
     virtual void setOutputTypeId(const QtNodes::PortIndex &inputIndex, const FdfUID &typeId);
     virtual void onFunctionInputSet(const PortIndex &index) override;
     virtual void onFunctionInputReset(const PortIndex &index) override;
     void updateDataPortsWithSignature();
     virtual bool canConnect(ConnectionInfo &connInfo) const override;
+    virtual bool acceptsConnection(const PortDescriptor &source,
+                                   PortIndex inIndex) const override;
 
 private:
-    inline static const QString NUM_SAMPLE = "num_sample";
-    inline static const QString TARGET = "target";
-    inline static const QString DIFF_STEP = "diff_step";
-    inline static const QString GRID_SIZE = "grid_size";
-
     int m_numSample = 1;
     int m_target = 0;
     int m_diffStep = 10;
@@ -169,4 +172,6 @@ public:
     virtual void onDataInputReset(const PortIndex &index);
     virtual void setOutputTypeId(const QtNodes::PortIndex &, const FdfUID &);
     virtual bool canConnect(ConnectionInfo &connInfo) const override;
+    // the difference is computed row-wise, a chunked input gives a chunked output
+    virtual bool acceptsChunkedInput() const override { return true; }
 };
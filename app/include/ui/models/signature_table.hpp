@@ -0,0 +1,64 @@
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <QDebug>
+
+#include "logging_categories.hpp"
+
+// UID type for data nodes
+using FdfUID = int;
+
+// UID type struct for function nodes
+struct Signature
+{
+    std::vector<FdfUID> inputs;
+    std::vector<FdfUID> outputs;
+    std::pair<size_t, size_t> size() const { return {inputs.size(), outputs.size()}; }
+    void update(unsigned int port, FdfUID typeId)
+    {
+        if (port < inputs.size())
+            inputs.at(port) = typeId;
+        else
+            outputs.at(port - inputs.size()) = typeId;
+    }
+    void inverse() { std::swap(inputs, outputs); }
+    bool isEmpty() const { return inputs.empty() && outputs.empty(); }
+    void print() const { qCDebug(lcTyping) << inputs << " => " << outputs; }
+    bool operator==(const Signature &other) const
+    {
+        return inputs == other.inputs && outputs == other.outputs;
+    }
+};
+
+struct SignatureHash
+{
+    size_t operator()(const Signature &signature) const;
+};
+
+// handle of an interned signature, equal handles mean equal signatures
+using SignatureId = unsigned int;
+
+// Interned, immutable signatures. Function ports keep a handle instead of their own copy,
+// so reading and comparing signatures does not copy or allocate. Signatures are made of type
+// ids, so each uid manager owns the table of its project and it goes with the project. It is
+// only used from the gui thread, snapshots copy the signatures they need.
+class SignatureTable
+{
+public:
+    inline static const SignatureId EMPTY_ID = 0;
+    SignatureTable();
+    SignatureTable(const SignatureTable &) = delete;
+    SignatureTable &operator=(const SignatureTable &) = delete;
+
+    SignatureId intern(const Signature &signature);
+    // the reference stays valid for the lifetime of the table
+    const Signature &get(SignatureId id) const { return m_signatures.at(id); }
+    size_t size() const { return m_signatures.size(); }
+
+private:
+    // deque, so growing the table keeps the handed out references valid
+    std::deque<Signature> m_signatures;
+    std::unordered_map<Signature, SignatureId, SignatureHash> m_ids;
+};
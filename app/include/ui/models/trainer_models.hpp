@@ -8,7 +8,7 @@ class TrainerModel : public FdfBlockModel
 public:
     TrainerModel(const QString &name, const QString &functionName);
     virtual bool portNumberModifiable(const PortType &portType) const override;
-    virtual uint minModifiablePorts(const PortType &portType, const QString &typeId) const override;
+    virtual uint minModifiablePorts(const PortType &portType, PortKind kind) const override;
     uint getTrainerInputPortNum() const { return m_signature.inputs.size(); }
     uint getTrainerOutputPortNum() const { return m_signature.outputs.size(); }
 
@@ -31,6 +31,9 @@ class BasicTrainerModel : public TrainerModel
 {
     Q_OBJECT
 public:
+    inline static const QString RANDOM_STATE = "random_state";
+    inline static const QString MODEL = "model";
+    inline static const QString HIDDEN_LAYER_SIZES = "hidden_layer_sizes";
     enum Model {
         Mlp,
         Mlp1,
@@ -42,7 +45,7 @@ public:
 
     BasicTrainerModel();
     virtual std::unordered_map<QString, QString> getParameters() const override;
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const override;
+    virtual ParameterSchema getParameterSchema() const override;
     virtual QStringList getParameterOptions(const QString &key) const override;
     virtual void setParameter(const QString &key, const QString &value) override;
     Model getModel() const { return m_model; }
@@ -56,10 +59,6 @@ public:
     }
 
 private:
-    inline static const QString RANDOM_STATE = "random_state";
-    inline static const QString MODEL = "model";
-    inline static const QString HIDDEN_LAYER_SIZES = "hidden_layer_sizes";
-
     Model m_model;
     std::optional<int> m_randomState;
     // only for mlp2
@@ -70,17 +69,16 @@ class TorchTrainerModel : public TrainerModel
 {
     Q_OBJECT
 public:
+    inline static const QString RANDOM_STATE = "random_state";
+    inline static const QString MAX_ITER = "max_iter";
+    inline static const QString LEARNING_RATE = "learning_rate";
     TorchTrainerModel();
     virtual bool hasParameters() const override { return true; }
     virtual std::unordered_map<QString, QString> getParameters() const override;
-    virtual std::unordered_map<QString, QMetaType::Type> getParameterSchema() const override;
+    virtual ParameterSchema getParameterSchema() const override;
     virtual void setParameter(const QString &key, const QString &value) override;
 
 private:
-    inline static const QString RANDOM_STATE = "random_state";
-    inline static const QString MAX_ITER = "max_iter";
-    inline static const QString LEARNING_RATE = "learning_rate";
-
     int m_randomState = 0;
     int m_maxIter = 1000;
     double m_learningRate = 0.001;
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "data/string_interner.hpp"
+#include "ui/models/signature_table.hpp"
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <QString>
 #include <QtNodes/Definitions>
 #include <QtNodes/DirectedAcyclicGraphModel>
@@ -8,43 +13,24 @@
 using QtNodes::NodeId;
 using QtNodes::PortIndex;
 
-// UID type for data nodes
-using FdfUID = int;
-
-// UID type struct for function nodes
-struct Signature
-{
-    std::vector<FdfUID> inputs;
-    std::vector<FdfUID> outputs;
-    std::pair<size_t, size_t> size() const { return {inputs.size(), outputs.size()}; }
-    void update(unsigned int port, FdfUID typeId)
-    {
-        if (port < inputs.size())
-            inputs.at(port) = typeId;
-        else
-            outputs.at(port - inputs.size()) = typeId;
-    }
-    void inverse() { std::swap(inputs, outputs); }
-    bool isEmpty() const { return inputs.empty() && outputs.empty(); }
-    void print() const { qDebug() << inputs << " => " << outputs; }
-};
-
 // struct to maintain connection information, to pass to fdf blocks
 struct ConnectionInfo
 {
     FdfUID expectedInType;
     FdfUID receivedOutType;
-    std::shared_ptr<Signature> receivedSignature;
+    // points into the signature table, no copy is made per connection probe
+    const Signature *receivedSignature;
     PortIndex inIndex;
     PortIndex outIndex;
     NodeId inNodeId;
     NodeId outNodeId;
     QString inBlockCaption;
     QString outBlockCaption;
+    bool receivedChunked = false;
 
     ConnectionInfo(FdfUID expectedIn = -1,
                    FdfUID receivedOut = -1,
-                   std::shared_ptr<Signature> signature = nullptr,
+                   const Signature *signature = nullptr,
                    PortIndex inIdx = -1,
                    PortIndex outIdx = -1,
                    NodeId inNode = -1,
@@ -63,13 +49,51 @@ struct ConnectionInfo
     {}
 };
 
+// where a type id is referenced on a port
+struct PortRef
+{
+    enum Role {
+        Data,            // the type id of a data port
+        SignatureInput,  // an entry of Signature::inputs of a function port
+        SignatureOutput, // an entry of Signature::outputs of a function port
+    };
+    Role role;
+    unsigned int position; // index inside the signature vector, 0 for data ports
+};
+
 class CustomGraph;
+class NamedNode;
 class UIDManager
 {
 public:
     inline static const FdfUID NONE_ID = -1;
     inline static const QString NONE_TAG = QStringLiteral("data_none");
-    UIDManager();
+
+    // while alive, ports and type ids are taken from this manager instead of the current
+    // tab's, so blocks built by a graph use the manager of that graph
+    class Binding
+    {
+    public:
+        explicit Binding(UIDManager *manager)
+            : m_previous(s_bound)
+        {
+            s_bound = manager;
+        }
+        ~Binding() { s_bound = m_previous; }
+        Binding(const Binding &) = delete;
+        Binding &operator=(const Binding &) = delete;
+
+    private:
+        UIDManager *m_previous;
+    };
+    static UIDManager *bound() { return s_bound; }
+
+    // the interner is shared with the graph of the same project
+    explicit UIDManager(std::shared_ptr<StringInterner> interner
+                        = std::make_shared<StringInterner>());
+    ~UIDManager();
+    UIDManager(const UIDManager &) = delete;
+    UIDManager &operator=(const UIDManager &) = delete;
     void setGraph(CustomGraph *tab_graph)
     {
         if (tab_graph)
@@ -82,17 +106,40 @@ public:
     void updateMap(FdfUID &uid, QString &tag);
     ConnectionInfo getConnectionInfo(QtNodes::ConnectionId const connectionId) const;
     QString getUniqueTag(QString tag);
+    // reverse index, ports register every type id they reference
+    void indexPort(NamedNode *port, FdfUID uid, PortRef ref);
+    void unindexPort(NamedNode *port, FdfUID uid);
+    size_t referenceCount(FdfUID uid) const;
+    // every port holding a pointer to this manager, indexed or not, is detached when the
+    // manager is destroyed
+    void bindPort(NamedNode *port) { boundPorts.insert(port); }
+    void releasePort(NamedNode *port) { boundPorts.erase(port); }
+    size_t boundPortCount() const { return boundPorts.size(); }
+    // ports visited by the last rename or override
+    size_t visitedPortCount() const { return lastVisited; }
+    StringInterner &interner() const { return *m_interner; }
+    SignatureTable &signatures() { return signatureTable; }
+    const SignatureTable &signatures() const { return signatureTable; }
 
 private:
+    inline static UIDManager *s_bound = nullptr;
     CustomGraph *graph = nullptr;
-    // The maps from type id to human-readable tag (one-to-one, both are unique)
-    std::map<FdfUID, QString> uidToTag = {{NONE_ID, NONE_TAG}};
-    std::map<QString, FdfUID> tagToUid = {{NONE_TAG, NONE_ID}};
+    std::shared_ptr<StringInterner> m_interner;
+    // The maps from type id to human-readable tag (one-to-one, both are unique), tags are atoms
+    std::map<FdfUID, Atom> uidToTag;
+    std::unordered_map<Atom, FdfUID> tagToUid;
+    // type id -> ports referencing it, so overrides and renames only visit the affected ports
+    std::unordered_map<FdfUID, std::unordered_map<NamedNode *, std::vector<PortRef>>> portIndex;
+    std::unordered_set<NamedNode *> boundPorts;
+    SignatureTable signatureTable;
+    size_t lastVisited = 0;
     // Helper functions to override and display the map
     void overrideType(FdfUID removeType, FdfUID keepType);
-    bool replaceTypesInUIDVector(std::vector<FdfUID> &vec, FdfUID keepType, FdfUID removeType);
     void displayMaps() const;
-    void refreshDisplayNames();
+    void refreshDisplayNames(FdfUID uid);
+    // keep captions unique and propagate the blocks owning the updated ports
+    void updateOwners(const std::vector<NamedNode *> &renamed,
+                      const std::vector<NamedNode *> &retyped);
     // TODO Later : Add map to store coder models to check the following :-
     // 1. iff all the Coder parameter are the same ^ all input types are same ->
     // we could reuse an existing type (T2 == T3).
@@ -2,6 +2,7 @@
 
 #include <QWidget>
 
+class QCheckBox;
 class QComboBox;
 class QSpinBox;
 class MainWindow;
@@ -20,5 +21,8 @@ private:
     QComboBox *m_formatBox;
     QComboBox *m_engineBox;
     QSpinBox *m_engineTimeoutBox;
+    QCheckBox *m_openGlBox;
+    // one per logging subsystem, empty when debug output is compiled out
+    QList<QCheckBox *> m_debugLogBoxes;
     MainWindow *mainWindowPtr;
 };
@@ -0,0 +1,93 @@
+"""Measure write/read throughput and size of the output codecs offered by func_out and data_out.
+
+Runs the same dataset classes and arguments that the builder writes to catalog.yml, so the
+numbers reflect what a generated kedro project does. Needs kedro-datasets, pyarrow, fsspec,
+lz4 and zstandard in the active environment (the kedro-umbrella backend provides them).
+
+usage: python benchmark_codecs.py [--rows N] [--cols N] [--repeat N]
+"""
+
+import argparse
+import tempfile
+import time
+from pathlib import Path
+
+import numpy as np
+import pandas as pd
+from kedro_datasets.pandas import FeatherDataset, ParquetDataset
+from kedro_datasets.pickle import PickleDataset
+
+CODECS = ["none", "lz4", "zstd"]
+LEVEL = 3
+
+
+def pickle_dataset(path, codec):
+    if codec == "none":
+        return PickleDataset(filepath=str(path))
+    suffix = {"lz4": ".lz4", "zstd": ".zst"}[codec]
+    return PickleDataset(
+        filepath=str(path) + suffix,
+        fs_args={
+            "open_args_save": {"mode": "wb", "compression": codec},
+            "open_args_load": {"mode": "rb", "compression": codec},
+        },
+    )
+
+
+def arrow_dataset(cls, path, codec):
+    if codec == "none":
+        # parquet only knows "none", feather only "uncompressed"
+        none = "none" if cls is ParquetDataset else "uncompressed"
+        return cls(filepath=str(path), save_args={"compression": none})
+    return cls(filepath=str(path), save_args={"compression": codec, "compression_level": LEVEL})
+
+
+def measure(dataset, data, repeat):
+    write, read = [], []
+    for _ in range(repeat):
+        start = time.perf_counter()
+        dataset.save(data)
+        write.append(time.perf_counter() - start)
+        start = time.perf_counter()
+        dataset.load()
+        read.append(time.perf_counter() - start)
+    return min(write), min(read)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--rows", type=int, default=1_000_000)
+    parser.add_argument("--cols", type=int, default=32)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    rng = np.random.default_rng(0)
+    # half noise, half smooth signals, closer to simulation output than pure noise
+    noise = rng.standard_normal((args.rows, args.cols // 2))
+    signal = np.cumsum(rng.standard_normal((args.rows, args.cols - args.cols // 2)), axis=0)
+    frame = pd.DataFrame(np.hstack([noise, signal]), columns=[f"c{i}" for i in range(args.cols)])
+    raw_mb = frame.memory_usage(index=False).sum() / 2**20
+
+    print(f"{args.rows} x {args.cols} float64, {raw_mb:.1f} MiB in memory")
+    print(f"{'format':<10}{'codec':<8}{'size MiB':>10}{'ratio':>8}{'write MiB/s':>13}{'read MiB/s':>12}")
+    with tempfile.TemporaryDirectory() as tmp:
+        for fmt in ["pickle", "parquet", "feather"]:
+            for codec in CODECS:
+                path = Path(tmp) / f"{fmt}_{codec}.{fmt}"
+                if fmt == "pickle":
+                    dataset = pickle_dataset(path, codec)
+                elif fmt == "parquet":
+                    dataset = arrow_dataset(ParquetDataset, path, codec)
+                else:
+                    dataset = arrow_dataset(FeatherDataset, path, codec)
+                write, read = measure(dataset, frame, args.repeat)
+                written = next(Path(tmp).glob(path.name + "*"))
+                size_mb = written.stat().st_size / 2**20
+                print(
+                    f"{fmt:<10}{codec:<8}{size_mb:>10.1f}{raw_mb / size_mb:>8.2f}"
+                    f"{raw_mb / write:>13.0f}{raw_mb / read:>12.0f}"
+                )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,130 @@
+"""Check that the installed backend runs the chunked pipelines the builder generates.
+
+Declares the data sources with the same catalog entries and load_args the builder writes to
+catalog.yml when a chunk size is set, runs difference and score on them and compares the
+results with the same pipeline loading the files at once. H5 sources are only checked when
+h5py is installed. Exits with a non zero status if the backend rejects an argument or the
+chunked results differ.
+
+usage: python check_chunked_backend.py [--rows N] [--chunk-size N]
+"""
+
+import argparse
+import os
+import sys
+import tempfile
+from pathlib import Path
+
+os.environ.setdefault("MPLBACKEND", "Agg")
+
+import numpy as np
+import pandas as pd
+import yaml
+from kedro.io import DataCatalog, MemoryDataset
+from kedro.pipeline import pipeline
+from kedro.runner import SequentialRunner
+from kedro_umbrella import processor
+from kedro_umbrella.library import *
+
+# %1..%3 of CATALOG_YML_ENTRY followed by the load_args of DataSourceModel::loadArgs
+CATALOG_ENTRY = """{name}:
+  type: {type}
+  filepath: '{path}'
+"""
+
+
+def catalog_entry(name, dataset_type, path, load_args):
+    entry = CATALOG_ENTRY.format(name=name, type=dataset_type, path=path)
+    if load_args:
+        entry += "  load_args:\n"
+        entry += "".join(f"    {key}: {value}\n" for key, value in load_args.items())
+    return entry
+
+
+def as_array(data):
+    # chunked results are iterables of row blocks
+    if isinstance(data, (pd.DataFrame, pd.Series, np.ndarray)):
+        return np.asarray(data)
+    return np.concatenate([np.asarray(block) for block in data])
+
+
+def run_pipeline(entries):
+    catalog = DataCatalog.from_config(yaml.safe_load("".join(entries)))
+    catalog.add("params:score", MemoryDataset({"plot": "regression"}))
+    # the same calls PIPELINE_PY lists for a difference and a score block
+    nodes = pipeline(
+        [
+            processor(func=difference, name="difference", inputs=["a", "b"], outputs="a_diff"),
+            processor(
+                func=score,
+                name="score",
+                inputs=["a", "b", "params:score"],
+                outputs=["nrmse", "r2"],
+            ),
+        ]
+    )
+    return SequentialRunner().run(nodes, catalog)
+
+
+def check_csv(tmp, rows, chunk_size):
+    rng = np.random.default_rng(0)
+    frames = {name: pd.DataFrame(rng.standard_normal((rows, 4))) for name in "ab"}
+    for name, frame in frames.items():
+        frame.to_csv(tmp / f"{name}.csv", index=False)
+
+    def entries(load_args):
+        return [catalog_entry(n, "pandas.CSVDataset", tmp / f"{n}.csv", load_args) for n in "ab"]
+
+    whole = run_pipeline(entries({}))
+    chunked = run_pipeline(entries({"chunksize": chunk_size}))
+    return compare("csv", whole, chunked)
+
+
+def check_h5(tmp, rows, chunk_size):
+    try:
+        import h5py
+    except ImportError:
+        print("h5: skipped, h5py is not installed")
+        return True
+    rng = np.random.default_rng(1)
+    for name in "ab":
+        with h5py.File(tmp / f"{name}.mat", "w") as file:
+            file["signal"] = rng.standard_normal((rows, 4))
+
+    def entries(load_args):
+        load_args = {"dataset": "'/signal'", **load_args}
+        return [
+            catalog_entry(n, "kedro_umbrella.library.H5Dataset", tmp / f"{n}.mat", load_args)
+            for n in "ab"
+        ]
+
+    whole = run_pipeline(entries({}))
+    chunked = run_pipeline(entries({"chunk_size": chunk_size}))
+    return compare("h5", whole, chunked)
+
+
+def compare(label, whole, chunked):
+    ok = True
+    for name in ["a_diff", "nrmse", "r2"]:
+        if not np.allclose(as_array(whole[name]), as_array(chunked[name])):
+            print(f"{label}: {name} differs between chunked and whole reads")
+            ok = False
+    if ok:
+        print(f"{label}: ok")
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--rows", type=int, default=10_000)
+    parser.add_argument("--chunk-size", type=int, default=1_000)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        ok = check_csv(Path(tmp), args.rows, args.chunk_size)
+        ok = check_h5(Path(tmp), args.rows, args.chunk_size) and ok
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
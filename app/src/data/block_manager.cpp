@@ -1,14 +1,23 @@
 #include "data/block_manager.hpp"
 
 #include <QDebug>
+#include <QDialog>
+#include <QPointer>
+#include <QThread>
+#include <QVBoxLayout>
 
 #include <QtNodes/ConnectionStyle>
 #include <QtNodes/DagGraphicsScene>
+#include <QtNodes/GraphicsView>
 #include <QtNodes/NodeDelegateModelRegistry>
 
 #include "data/custom_graph.hpp"
+#include "data/graph_layout.hpp"
 #include "data/tab_manager.hpp"
+#include "logging_categories.hpp"
+#include "ui/lod_node_painter.hpp"
 #include "ui/model_registry.hpp"
+#include "ui/models/composite_model.hpp"
 #include "ui/models/fdf_block_model.hpp"
 
 using QtNodes::ConnectionStyle;
@@ -82,11 +91,18 @@ void BlockManager::onTabCreated(QWidget *view)
                 &DagGraphicsScene::selectionChanged,
                 this,
                 &BlockManager::onSelectionChanged);
-        connect(tab->getGraph(),
-                &CustomGraph::nodePositionUpdated,
-                this,
-                &BlockManager::nodeUpdated);
-        connect(tab->getGraph(), &CustomGraph::nodeUpdated, this, &BlockManager::nodeUpdated);
+        auto graph = tab->getGraph();
+        // updates inside a batch are reported once it commits
+        auto forwardUpdate = [this, graph](QtNodes::NodeId id) {
+            if (!graph->inBatch())
+                emit nodeUpdated(id);
+        };
+        connect(graph, &CustomGraph::nodePositionUpdated, this, forwardUpdate);
+        connect(graph, &CustomGraph::nodeUpdated, this, forwardUpdate);
+        connect(graph, &CustomGraph::batchCommitted, this, [this]() {
+            for (const auto &id : m_selectedNodes)
+                emit nodeUpdated(id);
+        });
     }
 }
 
@@ -98,3 +114,71 @@ void BlockManager::onSelectionChanged()
     m_selectedNodes = scene->selectedNodes();
     emit nodeSelected(m_selectedNodes.size() < 1 ? QtNodes::InvalidNodeId : m_selectedNodes.front());
 }
+
+void BlockManager::groupSelectedBlocks()
+{
+    auto graph = m_tabManager->currentGraph();
+    if (!graph || m_selectedNodes.empty())
+        return;
+    auto id = graph->groupIntoComposite(
+        std::unordered_set<QtNodes::NodeId>(m_selectedNodes.begin(), m_selectedNodes.end()));
+    if (id == QtNodes::InvalidNodeId)
+        qCWarning(lcGraph) << "The selected blocks could not be grouped";
+}
+
+void BlockManager::editSelectedComposite()
+{
+    auto graph = m_tabManager->currentGraph();
+    if (!graph || m_selectedNodes.size() != 1)
+        return;
+    auto composite = graph->delegateModel<CompositeModel>(m_selectedNodes.front());
+    if (!composite) {
+        qCWarning(lcGraph) << "The selected block is not a composite block";
+        return;
+    }
+    auto subGraph = composite->expand();
+    {
+        QDialog dialog(m_tabManager->currentWidget());
+        dialog.setWindowTitle(composite->caption());
+        auto scene = new DagGraphicsScene(*subGraph, &dialog);
+        subGraph->attachScene(scene);
+        scene->setNodePainter(std::make_unique<LodNodePainter>());
+        auto layout = new QVBoxLayout(&dialog);
+        layout->addWidget(new QtNodes::GraphicsView(scene));
+        dialog.resize(800, 600);
+        dialog.exec();
+    }
+    // the scene is gone with the dialog, the blocks are kept as json again
+    composite->collapse();
+}
+
+void BlockManager::layoutCurrentGraph()
+{
+    auto graph = m_tabManager->currentGraph();
+    if (!graph)
+        return;
+    auto input = std::make_shared<data::LayoutGraph>();
+    for (const auto &nodeId : graph->allNodeIds()) {
+        input->nodes.push_back(nodeId);
+        input->sizes.emplace(nodeId,
+                             QSizeF(graph->nodeData(nodeId, QtNodes::NodeRole::Size).toSize()));
+        for (const auto &connectionId : graph->allConnectionIds(nodeId))
+            if (connectionId.outNodeId == nodeId)
+                input->edges.emplace_back(connectionId.outNodeId, connectionId.inNodeId);
+    }
+    auto positions = std::make_shared<std::unordered_map<QtNodes::NodeId, QPointF>>();
+    auto thread = QThread::create(
+        [input, positions]() { *positions = data::LayeredLayout::compute(*input); });
+    // the tab may be closed or edited while the layout runs
+    QPointer<CustomGraph> target(graph);
+    connect(thread, &QThread::finished, this, [target, positions]() {
+        if (!target)
+            return;
+        CustomGraph::Batch batch(*target);
+        for (const auto &pair : *positions)
+            if (target->nodeExists(pair.first))
+                target->setNodeData(pair.first, QtNodes::NodeRole::Position, pair.second);
+    });
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start();
+}
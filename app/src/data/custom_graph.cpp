@@ -1,6 +1,10 @@
 #include "data/custom_graph.hpp"
 
+#include "data/block_manager.hpp"
+#include "data/graph_snapshot.hpp"
 #include "data/tab_manager.hpp"
+#include "logging_categories.hpp"
+#include "ui/models/composite_model.hpp"
 #include "ui/models/fdf_block_model.hpp"
 #include "ui/models/io_models.hpp"
 #include "ui/models/processor_models.hpp"
@@ -9,37 +13,169 @@
 #include <QMessageBox>
 #include <QMetaObject>
 
-using QtNodes::NodeRole;
+#include <QtNodes/BasicGraphicsScene>
+
 using QtNodes::PortRole;
 namespace {
 
+// base name if free, otherwise the next free "<base>_N", probing from the last suffix handed
+// out for the base so similarly named blocks don't rescan all the previous suffixes
 template<typename MapType>
-void removeByValue(MapType &map, const typename MapType::mapped_type &valueToRemove)
+Atom uniqueName(StringInterner &interner,
+                const Atom base,
+                const MapType &used,
+                std::unordered_map<Atom, uint> &nextSuffix)
 {
-    for (auto it = map.begin(); it != map.end();)
-        if (it->second == valueToRemove)
-            it = map.erase(it);
-        else
-            ++it;
+    if (used.count(base) < 1)
+        return base;
+    uint &counter = nextSuffix.try_emplace(base, 2).first->second;
+    // probed names are only looked up, the interner keeps the one handed out
+    QString name;
+    do {
+        name = QString("%1_%2").arg(interner.string(base), QString::number(counter++));
+    } while (used.count(interner.find(name)) > 0);
+    return interner.intern(name);
 }
 
-template<typename MapType>
-void removeByPairFirst(MapType &map,
-                       const typename MapType::mapped_type::first_type &firstValueToRemove)
+} // namespace
+
+CustomGraph::CustomGraph(std::shared_ptr<QtNodes::NodeDelegateModelRegistry> registry,
+                         std::shared_ptr<StringInterner> interner)
+    : DirectedAcyclicGraphModel(registry)
+    , m_interner(interner)
+    , m_ownUIDManager(std::make_unique<UIDManager>(interner))
 {
-    for (auto it = map.begin(); it != map.end();)
-        if (it->second.first == firstValueToRemove)
-            it = map.erase(it);
+    m_ownUIDManager->setGraph(this);
+    connect(this, &CustomGraph::nodeDeleted, this, &CustomGraph::onNodeDeleted);
+    connect(this, &CustomGraph::nodeCreated, this, [this](const QtNodes::NodeId nodeId) {
+        if (m_sceneBatchDepth > 0)
+            m_sceneNodes.push_back(nodeId);
         else
-            ++it;
+            emit sceneNodeCreated(nodeId);
+    });
+    connect(this,
+            &CustomGraph::connectionCreated,
+            this,
+            [this](const QtNodes::ConnectionId connectionId) {
+                if (m_sceneBatchDepth > 0)
+                    m_sceneConnections.push_back(connectionId);
+                else
+                    emit sceneConnectionCreated(connectionId);
+            });
+    auto clearRanks = [this]() { m_topologicalRanks.clear(); };
+    connect(this, &CustomGraph::nodeCreated, this, clearRanks);
+    connect(this, &CustomGraph::nodeDeleted, this, clearRanks);
+    connect(this, &CustomGraph::connectionCreated, this, clearRanks);
+    connect(this, &CustomGraph::connectionDeleted, this, clearRanks);
+    connect(this, &CustomGraph::nodeDeleted, this, [this]() { m_snapshotStructureDirty = true; });
+    auto snapshotConnection = [this](const QtNodes::ConnectionId connectionId) {
+        m_snapshotStructureDirty = true;
+        m_snapshotDirty.insert(connectionId.inNodeId);
+        m_snapshotDirty.insert(connectionId.outNodeId);
+    };
+    connect(this, &CustomGraph::connectionCreated, this, snapshotConnection);
+    connect(this, &CustomGraph::connectionDeleted, this, snapshotConnection);
+    connect(this,
+            &CustomGraph::connectionCreated,
+            this,
+            [this](const QtNodes::ConnectionId connectionId) {
+                if (!m_componentsStale)
+                    uniteComponents(connectionId.outNodeId, connectionId.inNodeId);
+                markValidityDirty(connectionId.inNodeId);
+            });
+    connect(this,
+            &CustomGraph::connectionDeleted,
+            this,
+            [this](const QtNodes::ConnectionId connectionId) {
+                m_componentsStale = true;
+                markValidityDirty(connectionId.inNodeId);
+            });
 }
 
-} // namespace
+void CustomGraph::beginBatch(bool deferScene)
+{
+    ++m_batchDepth;
+    if (deferScene)
+        ++m_sceneBatchDepth;
+}
 
-CustomGraph::CustomGraph(std::shared_ptr<QtNodes::NodeDelegateModelRegistry> registry)
-    : DirectedAcyclicGraphModel(registry)
+void CustomGraph::commit(bool deferScene)
 {
-    connect(this, &CustomGraph::nodeDeleted, this, &CustomGraph::onNodeDeleted);
+    if (m_batchDepth == 0) {
+        qCWarning(lcGraph) << "Graph batch committed without being started";
+        return;
+    }
+    if (deferScene && m_sceneBatchDepth > 0)
+        --m_sceneBatchDepth;
+    if (--m_batchDepth > 0)
+        return;
+
+    std::set<QtNodes::NodeId> pendingNodes;
+    std::swap(pendingNodes, m_pendingNodes);
+    for (const auto &nodeId : pendingNodes)
+        if (auto block = delegateModel<FdfBlockModel>(nodeId)) {
+            makeCaptionUnique(nodeId, block);
+            makeOutPortsUnique(nodeId, block);
+            stylePorts(nodeId, block);
+        }
+
+    // the items are built once with the final captions and port styles
+    std::vector<QtNodes::NodeId> sceneNodes;
+    std::swap(sceneNodes, m_sceneNodes);
+    for (const auto &nodeId : sceneNodes)
+        if (nodeExists(nodeId))
+            emit sceneNodeCreated(nodeId);
+    std::vector<QtNodes::ConnectionId> sceneConnections;
+    std::swap(sceneConnections, m_sceneConnections);
+    for (const auto &connectionId : sceneConnections)
+        if (connectionExists(connectionId))
+            emit sceneConnectionCreated(connectionId);
+
+    std::set<QtNodes::NodeId> pendingPropagation;
+    std::swap(pendingPropagation, m_pendingPropagation);
+    for (const auto &nodeId : pendingPropagation)
+        m_dirtyNodes.insert({topologicalRank(nodeId), nodeId});
+    processPropagation();
+
+    std::set<QtNodes::NodeId> updatedNodes;
+    std::swap(updatedNodes, m_updatedNodes);
+    for (const auto &nodeId : updatedNodes)
+        if (nodeExists(nodeId))
+            emit nodeUpdated(nodeId);
+    emit batchCommitted();
+}
+
+void CustomGraph::attachScene(QtNodes::BasicGraphicsScene *scene)
+{
+    using QtNodes::BasicGraphicsScene;
+    disconnect(this, &CustomGraph::nodeCreated, scene, &BasicGraphicsScene::onNodeCreated);
+    disconnect(this,
+               &CustomGraph::connectionCreated,
+               scene,
+               &BasicGraphicsScene::onConnectionCreated);
+    connect(this, &CustomGraph::sceneNodeCreated, scene, &BasicGraphicsScene::onNodeCreated);
+    connect(this,
+            &CustomGraph::sceneConnectionCreated,
+            scene,
+            &BasicGraphicsScene::onConnectionCreated);
+}
+
+bool CustomGraph::deferUntilCommit(const QtNodes::NodeId nodeId)
+{
+    if (m_batchDepth == 0)
+        return false;
+    if (m_pendingNodes.insert(nodeId).second)
+        // all its out ports are registered again at commit
+        releaseOutPortCaptions(nodeId);
+    return true;
+}
+
+void CustomGraph::notifyNodeUpdated(const QtNodes::NodeId nodeId)
+{
+    if (m_batchDepth > 0)
+        m_updatedNodes.insert(nodeId);
+    else
+        emit nodeUpdated(nodeId);
 }
 
 std::vector<DataSourceModel *> CustomGraph::getDataSourceModels() const
@@ -59,22 +195,78 @@ std::vector<FuncOutModel *> CustomGraph::getFuncOutModels() const
     return result;
 }
 
+std::vector<DataOutModel *> CustomGraph::getDataOutModels() const
+{
+    std::vector<DataOutModel *> result;
+    for (auto &id : m_dataOutNodes)
+        result.push_back(delegateModel<DataOutModel>(id));
+    return result;
+}
+
+QtNodes::NodeId CustomGraph::addNode(QString const nodeType)
+{
+    UIDManager::Binding binding(uidManager());
+    return DirectedAcyclicGraphModel::addNode(nodeType);
+}
+
+void CustomGraph::loadNode(QJsonObject const &nodeJson)
+{
+    // also used by paste and undo
+    UIDManager::Binding binding(uidManager());
+    DirectedAcyclicGraphModel::loadNode(nodeJson);
+}
+
+void CustomGraph::addConnection(QtNodes::ConnectionId const connectionId)
+{
+    auto inBlock = delegateModel<FdfBlockModel>(connectionId.inNodeId);
+    auto outBlock = delegateModel<FdfBlockModel>(connectionId.outNodeId);
+    if (inBlock && outBlock
+        && inBlock->kindAt(PortType::In, connectionId.inPortIndex)
+               != outBlock->kindAt(PortType::Out, connectionId.outPortIndex)) {
+        qCWarning(lcGraph) << "Dropped connection from" << outBlock->caption() << "to"
+                           << inBlock->caption() << ", the ports hold different kinds of data";
+        return;
+    }
+    DirectedAcyclicGraphModel::addConnection(connectionId);
+}
+
 bool CustomGraph::connectionPossible(QtNodes::ConnectionId const connectionId) const
 {
     if (QApplication::mouseButtons() != Qt::NoButton) {
-        return true; // Ignore connection check if mouse is still pressed
+        // still dragging, only the cheap checks, the full check and its dialogs run on release
+        auto inBlock = delegateModel<FdfBlockModel>(connectionId.inNodeId);
+        auto outBlock = delegateModel<FdfBlockModel>(connectionId.outNodeId);
+        if (!inBlock || !outBlock)
+            return true;
+        return inBlock->acceptsConnection(outBlock->outPortDescriptor(connectionId.outPortIndex),
+                                          connectionId.inPortIndex);
     }
 
-    auto uidManager = TabManager::getUIDManager();
-    ConnectionInfo connInfo = uidManager->getConnectionInfo(connectionId);
+    ConnectionInfo connInfo = uidManager()->getConnectionInfo(connectionId);
     if (auto block = delegateModel<FdfBlockModel>(connInfo.inNodeId)) {
-        auto result = block->canConnect(connInfo);
+        auto result = block->verifyConnection(connInfo);
         if (!result)
             return false;
     }
     return DirectedAcyclicGraphModel::connectionPossible(connectionId);
 }
 
+bool CustomGraph::setNodeData(QtNodes::NodeId nodeId, QtNodes::NodeRole role, QVariant value)
+{
+    if (role == QtNodes::NodeRole::Size)
+        if (auto block = delegateModel<FdfBlockModel>(nodeId)) {
+            auto content = block->contentSize();
+            if (!content.isEmpty()) {
+                auto size = value.toSize();
+                size.setWidth(
+                    std::max(size.width(), content.width() + 2 * FdfBlockModel::CONTENT_MARGIN));
+                size.setHeight(size.height() + content.height() + FdfBlockModel::CONTENT_MARGIN);
+                value = size;
+            }
+        }
+    return DirectedAcyclicGraphModel::setNodeData(nodeId, role, value);
+}
+
 void CustomGraph::initBlockConnections(const QtNodes::NodeId nodeId, FdfBlockModel *block)
 {
     connect(block, &FdfBlockModel::captionUpdated, this, [this, block, nodeId]() {
@@ -92,6 +284,25 @@ void CustomGraph::initBlockConnections(const QtNodes::NodeId nodeId, FdfBlockMod
     connect(block, &FdfBlockModel::outPortDeleted, this, [nodeId, this](const PortIndex index) {
         onOutPortDeleted(nodeId, index);
     });
+    connect(block, &FdfBlockModel::propagationRequested, this, [nodeId, this]() {
+        markValidityDirty(nodeId);
+        requestPropagation(nodeId);
+    });
+    // rows, datasets or chunk sizes can make a block invalid
+    auto validityDirty = [nodeId, this]() { markValidityDirty(nodeId); };
+    connect(block, &FdfBlockModel::parameterUpdated, this, validityDirty);
+    connect(block, &FdfBlockModel::contentUpdated, this, validityDirty);
+    // the scene resizes and repaints the block
+    connect(block, &FdfBlockModel::paintedContentUpdated, this, [nodeId, this]() {
+        notifyNodeUpdated(nodeId);
+    });
+    // everything copied into the snapshot of the block
+    auto snapshotDirty = [nodeId, this]() { m_snapshotDirty.insert(nodeId); };
+    connect(block, &FdfBlockModel::captionUpdated, this, snapshotDirty);
+    connect(block, &FdfBlockModel::outPortCaptionUpdated, this, snapshotDirty);
+    connect(block, &FdfBlockModel::parameterUpdated, this, snapshotDirty);
+    connect(block, &FdfBlockModel::contentUpdated, this, snapshotDirty);
+    connect(block, &FdfBlockModel::propagationRequested, this, snapshotDirty);
 }
 
 void CustomGraph::onNodeCreated(const QtNodes::NodeId nodeId)
@@ -100,7 +311,15 @@ void CustomGraph::onNodeCreated(const QtNodes::NodeId nodeId)
     auto block = delegateModel<FdfBlockModel>(nodeId);
     if (!block)
         return;
+    block->setNodeId(nodeId);
     initBlockConnections(nodeId, block);
+    if (!m_componentsStale) {
+        m_componentParent[nodeId] = nodeId;
+        ++m_componentCount;
+    }
+    markValidityDirty(nodeId);
+    m_snapshotDirty.insert(nodeId);
+    m_snapshotStructureDirty = true;
     makeCaptionUnique(nodeId, block);
     makeOutPortsUnique(nodeId, block);
     stylePorts(nodeId, block);
@@ -111,22 +330,23 @@ void CustomGraph::onNodeCreated(const QtNodes::NodeId nodeId)
         connect(dataSourceModel, &DataSourceModel::importClicked, this, [nodeId, this]() {
             emit dataSourceModelImportClicked(nodeId);
         });
-    } else if (block->name() == io_names::FUNC_OUT)
+    } else if (block->name() == composite_names::COMPOSITE)
+        static_cast<CompositeModel *>(block)->setParentGraph(this);
+    else if (block->name() == io_names::FUNC_OUT)
         m_funcOutNodes.insert(nodeId);
+    else if (block->name() == io_names::DATA_OUT)
+        m_dataOutNodes.insert(nodeId);
 }
 
 void CustomGraph::stylePorts(const QtNodes::NodeId &nodeId, FdfBlockModel *block)
 {
-    if (!block)
+    if (!block || deferUntilCommit(nodeId))
         return;
 
-    auto styleFunctionPorts = [&](PortType portType, NodeRole rolePortCount) {
-        unsigned int portCount = nodeData(nodeId, rolePortCount).toUInt();
-        for (PortIndex portIndex = 0; portIndex < portCount; ++portIndex) {
-            auto data = portData(nodeId, portType, portIndex, PortRole::DataType);
-            assert(data.isValid() && data.canConvert<NodeDataType>());
-            // Check if the port is associated with a FunctionNode
-            if (constants::isFunctionNode(data.value<NodeDataType>())) {
+    auto styleFunctionPorts = [&](PortType portType) {
+        for (PortIndex portIndex = 0; portIndex < block->nPorts(portType); ++portIndex) {
+            // the kind tag of the port, no need to compare the data type ids
+            if (block->kindAt(portType, portIndex) == FunctionPort) {
                 setPortData(nodeId,
                             portType,
                             portIndex,
@@ -136,19 +356,31 @@ void CustomGraph::stylePorts(const QtNodes::NodeId &nodeId, FdfBlockModel *block
         }
     };
 
-    styleFunctionPorts(PortType::In, NodeRole::InPortCount);
-    styleFunctionPorts(PortType::Out, NodeRole::OutPortCount);
+    styleFunctionPorts(PortType::In);
+    styleFunctionPorts(PortType::Out);
 }
 
 void CustomGraph::onNodeDeleted(const QtNodes::NodeId nodeId)
 {
-    removeByValue(m_usedNodeCaptions, nodeId);
-    removeByPairFirst(m_usedOutPortCaptions, nodeId);
+    m_pendingNodes.erase(nodeId);
+    m_pendingPropagation.erase(nodeId);
+    m_updatedNodes.erase(nodeId);
+    m_validityDirty.erase(nodeId);
+    m_nodeIssues.erase(nodeId);
+    m_snapshotDirty.erase(nodeId);
+    m_componentsStale = true;
+    auto caption = m_nodeCaptions.find(nodeId);
+    if (caption != m_nodeCaptions.end()) {
+        m_usedNodeCaptions.erase(caption->second);
+        m_nodeCaptions.erase(caption);
+    }
+    releaseOutPortCaptions(nodeId);
+    m_nodeOutPortCaptions.erase(nodeId);
     if (m_dataSourceNodes.find(nodeId) != m_dataSourceNodes.end())
         m_dataSourceNodes.erase(nodeId);
     if (m_funcOutNodes.find(nodeId) != m_funcOutNodes.end())
         m_funcOutNodes.erase(nodeId);
-    m_trackedNodes.erase(nodeId);
+    m_dataOutNodes.erase(nodeId);
 }
 
 void CustomGraph::onOutPortInserted(const QtNodes::NodeId nodeId, const QtNodes::PortIndex oldIndex)
@@ -161,40 +393,55 @@ void CustomGraph::onOutPortInserted(const QtNodes::NodeId nodeId, const QtNodes:
 
 void CustomGraph::onOutPortDeleted(const QtNodes::NodeId nodeId, const QtNodes::PortIndex oldIndex)
 {
-    removeByValue(m_usedOutPortCaptions, std::make_pair(nodeId, oldIndex));
-    auto block = delegateModel<FdfBlockModel>(nodeId);
-    if (!block)
+    if (deferUntilCommit(nodeId))
         return;
-    if (block->nPorts(PortType::Out) > oldIndex)
-        // shift index of ports after the deleted one
-        for (int i = oldIndex; i < block->nPorts(PortType::Out); ++i) {
-            auto caption = block->portCaption(PortType::Out, i);
-            --m_usedOutPortCaptions.at(caption).second;
-        }
+    auto ports = m_nodeOutPortCaptions.find(nodeId);
+    if (ports == m_nodeOutPortCaptions.end() || ports->second.size() <= oldIndex)
+        return;
+    auto &names = ports->second;
+    if (names.at(oldIndex) != StringInterner::EMPTY_ATOM)
+        m_usedOutPortCaptions.erase(names.at(oldIndex));
+    names.erase(names.begin() + oldIndex);
+    // shift index of ports after the deleted one
+    for (PortIndex i = oldIndex; i < names.size(); ++i)
+        if (names.at(i) != StringInterner::EMPTY_ATOM)
+            m_usedOutPortCaptions[names.at(i)].second = i;
+}
+
+void CustomGraph::releaseOutPortCaptions(const QtNodes::NodeId nodeId)
+{
+    auto ports = m_nodeOutPortCaptions.find(nodeId);
+    if (ports == m_nodeOutPortCaptions.end())
+        return;
+    for (auto &name : ports->second) {
+        if (name != StringInterner::EMPTY_ATOM)
+            m_usedOutPortCaptions.erase(name);
+        name = StringInterner::EMPTY_ATOM;
+    }
 }
 
 void CustomGraph::makeCaptionUnique(const QtNodes::NodeId &nodeId, FdfBlockModel *block)
 {
-    QString uniqueCaption = block->caption();
-    uint counter = 1;
-    if (m_trackedNodes.count(nodeId) > 0) { // if node is already tracked
-        if (m_usedNodeCaptions.count(uniqueCaption) > 0
-            && m_usedNodeCaptions.at(uniqueCaption) == nodeId)
+    if (deferUntilCommit(nodeId))
+        return;
+    Atom caption = m_interner->intern(block->caption());
+    auto tracked = m_nodeCaptions.find(nodeId);
+    if (tracked != m_nodeCaptions.end()) { // if node is already tracked
+        if (tracked->second == caption)
             return;
         // if caption is different, remove old caption
-        removeByValue(m_usedNodeCaptions, nodeId);
+        m_usedNodeCaptions.erase(tracked->second);
     }
-    while (m_usedNodeCaptions.count(uniqueCaption) > 0)
-        uniqueCaption = QString("%1_%2").arg(block->caption(), QString::number(++counter));
+    Atom uniqueCaption = uniqueName(*m_interner, caption, m_usedNodeCaptions, m_nextCaptionSuffix);
     m_usedNodeCaptions[uniqueCaption] = nodeId;
-    m_trackedNodes.insert(nodeId);
-    if (block->caption() != uniqueCaption)
-        block->setCaption(uniqueCaption);
+    m_nodeCaptions[nodeId] = uniqueCaption;
+    if (caption != uniqueCaption)
+        block->setCaption(m_interner->string(uniqueCaption));
 }
 
 FdfBlockModel *CustomGraph::getBlockByCaption(const QString &caption) const
 {
-    auto it = m_usedNodeCaptions.find(caption);
+    auto it = m_usedNodeCaptions.find(m_interner->find(caption));
     if (it != m_usedNodeCaptions.end()) {
         auto nodeId = it->second;
         return delegateModel<FdfBlockModel>(nodeId);
@@ -204,6 +451,8 @@ FdfBlockModel *CustomGraph::getBlockByCaption(const QString &caption) const
 
 void CustomGraph::makeOutPortsUnique(const QtNodes::NodeId &nodeId, FdfBlockModel *block)
 {
+    if (deferUntilCommit(nodeId))
+        return;
     auto portType = QtNodes::PortType::Out;
     for (uint i = 0; i < block->nPorts(portType); ++i) {
         makeOutPortsUnique(nodeId, block, i);
@@ -214,36 +463,304 @@ void CustomGraph::makeOutPortsUnique(const QtNodes::NodeId &nodeId,
                                      FdfBlockModel *block,
                                      const PortIndex &index)
 {
+    if (deferUntilCommit(nodeId))
+        return;
     auto portType = QtNodes::PortType::Out;
-    const auto ORIGINAL_NAME = block->portCaption(portType, index);
-    uint counter = 1;
+    const auto ORIGINAL_NAME = m_interner->intern(block->portCaption(portType, index));
 
-    if (m_trackedNodes.count(nodeId) > 0) {
-        if (m_usedOutPortCaptions.count(ORIGINAL_NAME) > 0
-            && m_usedOutPortCaptions.at(ORIGINAL_NAME) == std::make_pair(nodeId, index))
+    auto &names = m_nodeOutPortCaptions[nodeId];
+    if (names.size() <= index)
+        names.resize(index + 1, StringInterner::EMPTY_ATOM);
+    if (names.at(index) != StringInterner::EMPTY_ATOM) {
+        if (names.at(index) == ORIGINAL_NAME)
             return;
         // if caption is different, remove old caption
-        removeByValue(m_usedOutPortCaptions, std::make_pair(nodeId, index));
+        m_usedOutPortCaptions.erase(names.at(index));
+    }
+    auto uniqueCaption = uniqueName(*m_interner,
+                                    ORIGINAL_NAME,
+                                    m_usedOutPortCaptions,
+                                    m_nextOutPortSuffix);
+    m_usedOutPortCaptions[uniqueCaption] = std::make_pair(nodeId, index);
+    // registered before renaming, the caption update signal re-enters this function
+    names.at(index) = uniqueCaption;
+    block->setPortCaption(portType, index, m_interner->string(uniqueCaption));
+}
+
+void CustomGraph::requestPropagation(const QtNodes::NodeId nodeId)
+{
+    if (m_batchDepth > 0) {
+        m_pendingPropagation.insert(nodeId);
+        return;
+    }
+    m_dirtyNodes.insert({topologicalRank(nodeId), nodeId});
+    processPropagation();
+}
+
+void CustomGraph::processPropagation()
+{
+    // requests made while pushing outputs only mark the downstream blocks, which come later
+    // in the order, so every block is processed once however many paths lead to it
+    if (m_propagating)
+        return;
+    m_propagating = true;
+    while (!m_dirtyNodes.empty()) {
+        auto next = m_dirtyNodes.begin()->second;
+        m_dirtyNodes.erase(m_dirtyNodes.begin());
+        if (auto block = delegateModel<FdfBlockModel>(next))
+            for (PortIndex i = 0; i < block->nPorts(PortType::Out); ++i)
+                emit block->dataUpdated(i);
     }
-    auto uniqueName = ORIGINAL_NAME;
-    while (m_usedOutPortCaptions.count(uniqueName) > 0) {
-        uniqueName = QString("%1_%2").arg(ORIGINAL_NAME, QString::number(++counter));
+    m_propagating = false;
+}
+
+size_t CustomGraph::topologicalRank(const QtNodes::NodeId nodeId)
+{
+    if (m_topologicalRanks.empty()) {
+        size_t rank = 0;
+        for (const auto &id : topologicalOrder())
+            m_topologicalRanks[id] = rank++;
     }
-    m_usedOutPortCaptions[uniqueName] = std::make_pair(nodeId, index);
-    block->setPortCaption(portType, index, uniqueName);
+    auto rank = m_topologicalRanks.find(nodeId);
+    return rank == m_topologicalRanks.end() ? m_topologicalRanks.size() : rank->second;
+}
+
+bool CustomGraph::allBlocksValid()
+{
+    if (!m_validityDirty.empty())
+        updateValidity();
+    return m_nodeIssues.empty();
+}
+
+std::unordered_map<QtNodes::NodeId, QStringList> CustomGraph::validityIssues()
+{
+    if (!m_validityDirty.empty())
+        updateValidity();
+    return m_nodeIssues;
+}
+
+size_t CustomGraph::componentCount()
+{
+    if (m_componentsStale)
+        rebuildComponents();
+    return m_componentCount;
+}
+
+void CustomGraph::markValidityDirty(const QtNodes::NodeId nodeId)
+{
+    m_validityDirty.insert(nodeId);
+    if (m_validationScheduled)
+        return;
+    // checked once the current changes are done, so the blocks are highlighted live
+    m_validationScheduled = true;
+    QMetaObject::invokeMethod(this, &CustomGraph::updateValidity, Qt::QueuedConnection);
 }
 
-bool CustomGraph::verifyBlocksValidity() const
+void CustomGraph::updateValidity()
 {
-    for (const auto &nodeId : allNodeIds()) {
+    m_validationScheduled = false;
+    std::unordered_set<QtNodes::NodeId> dirty;
+    std::swap(dirty, m_validityDirty);
+    for (const auto &nodeId : dirty) {
         auto block = delegateModel<FdfBlockModel>(nodeId);
-        if (!block) {
-            qWarning() << "Block with ID" << nodeId << "is not a valid FdfBlockModel.";
+        if (!block)
             continue;
+        auto issues = block->validityIssues();
+        bool wasValid = m_nodeIssues.count(nodeId) < 1;
+        if (issues.isEmpty())
+            m_nodeIssues.erase(nodeId);
+        else
+            m_nodeIssues[nodeId] = issues;
+        if (wasValid == issues.isEmpty())
+            continue;
+        block->setInvalidHighlight(!issues.isEmpty());
+        notifyNodeUpdated(nodeId);
+        emit validityChanged(nodeId, issues.isEmpty());
+    }
+}
+
+QtNodes::NodeId CustomGraph::findComponent(QtNodes::NodeId nodeId)
+{
+    // path halving
+    while (m_componentParent.at(nodeId) != nodeId) {
+        auto &parent = m_componentParent.at(nodeId);
+        parent = m_componentParent.at(parent);
+        nodeId = parent;
+    }
+    return nodeId;
+}
+
+void CustomGraph::uniteComponents(const QtNodes::NodeId first, const QtNodes::NodeId second)
+{
+    if (m_componentParent.count(first) < 1 || m_componentParent.count(second) < 1)
+        return;
+    auto firstRoot = findComponent(first);
+    auto secondRoot = findComponent(second);
+    if (firstRoot == secondRoot)
+        return;
+    m_componentParent[secondRoot] = firstRoot;
+    --m_componentCount;
+}
+
+void CustomGraph::rebuildComponents()
+{
+    m_componentParent.clear();
+    auto nodeIds = allNodeIds();
+    for (const auto &nodeId : nodeIds)
+        m_componentParent[nodeId] = nodeId;
+    m_componentCount = nodeIds.size();
+    for (const auto &nodeId : nodeIds)
+        for (const auto &connectionId : allConnectionIds(nodeId))
+            uniteComponents(connectionId.outNodeId, connectionId.inNodeId);
+    m_componentsStale = false;
+}
+
+std::shared_ptr<const GraphSnapshot> CustomGraph::snapshot()
+{
+    if (m_snapshot && m_snapshotDirty.empty() && !m_snapshotStructureDirty)
+        return m_snapshot;
+    auto result = std::make_shared<GraphSnapshot>();
+    result->version = m_snapshot ? m_snapshot->version + 1 : 1;
+
+    // in ports are named after the out ports upstream, so the blocks downstream are copied too
+    std::unordered_set<QtNodes::NodeId> dirty;
+    std::swap(dirty, m_snapshotDirty);
+    std::vector<QtNodes::NodeId> changed(dirty.begin(), dirty.end());
+    for (const auto &nodeId : changed)
+        if (nodeExists(nodeId))
+            for (const auto &connectionId : allConnectionIds(nodeId))
+                if (connectionId.outNodeId == nodeId)
+                    dirty.insert(connectionId.inNodeId);
+
+    auto copyNode = [&](const QtNodes::NodeId nodeId) {
+        if (m_snapshot && dirty.count(nodeId) < 1)
+            if (auto previous = m_snapshot->nodes.find(nodeId);
+                previous != m_snapshot->nodes.end()) {
+                result->nodes.emplace(nodeId, previous->second);
+                return;
+            }
+        if (auto block = delegateModel<FdfBlockModel>(nodeId))
+            result->nodes.emplace(nodeId, NodeSnapshot::fromBlock(nodeId, *block));
+    };
+    if (m_snapshotStructureDirty || !m_snapshot) {
+        for (const auto &nodeId : allNodeIds()) {
+            copyNode(nodeId);
+            for (const auto &connectionId : allConnectionIds(nodeId))
+                if (connectionId.outNodeId == nodeId)
+                    result->connections.push_back(connectionId);
         }
-        if (!block->checkBlockValidity()) {
-            return false;
+        auto order = topologicalOrder();
+        result->topologicalOrder.assign(order.begin(), order.end());
+    } else {
+        // same nodes and connections, only the changed blocks are copied
+        result->nodes = m_snapshot->nodes;
+        result->topologicalOrder = m_snapshot->topologicalOrder;
+        result->connections = m_snapshot->connections;
+        for (const auto &nodeId : dirty) {
+            result->nodes.erase(nodeId);
+            copyNode(nodeId);
         }
     }
-    return true;
-}
\ No newline at end of file
+    m_snapshotStructureDirty = false;
+    m_snapshot = result;
+    return m_snapshot;
+}
+
+QtNodes::NodeId CustomGraph::groupIntoComposite(const std::unordered_set<QtNodes::NodeId> &nodeIds)
+{
+    if (nodeIds.empty())
+        return QtNodes::InvalidNodeId;
+    // connections inside the group, entering it and leaving it
+    std::vector<QtNodes::ConnectionId> internal, incoming, outgoing;
+    for (const auto &nodeId : nodeIds) {
+        auto groupedBlock = delegateModel<FdfBlockModel>(nodeId);
+        if (!groupedBlock)
+            return QtNodes::InvalidNodeId;
+        // the catalog only declares the data and outputs of the top level pipeline
+        if (groupedBlock->type() == FdfBlockModel::FdfType::Data
+            || groupedBlock->type() == FdfBlockModel::FdfType::Output) {
+            qCWarning(lcGraph) << "Data and output blocks cannot be part of a composite block";
+            return QtNodes::InvalidNodeId;
+        }
+        for (const auto &connectionId : allConnectionIds(nodeId)) {
+            bool fromInside = nodeIds.count(connectionId.outNodeId) > 0;
+            bool toInside = nodeIds.count(connectionId.inNodeId) > 0;
+            if (fromInside && toInside) {
+                if (connectionId.outNodeId == nodeId)
+                    internal.push_back(connectionId);
+                continue;
+            }
+            auto block = delegateModel<FdfBlockModel>(connectionId.outNodeId);
+            if (block->kindAt(PortType::Out, connectionId.outPortIndex) != DataPort) {
+                qCWarning(lcGraph) << "Only data can cross the boundary of a composite block";
+                return QtNodes::InvalidNodeId;
+            }
+            (toInside ? incoming : outgoing).push_back(connectionId);
+        }
+    }
+
+    // one boundary block per out port crossing it, in the order of the composite ports
+    using Source = std::pair<QtNodes::NodeId, QtNodes::PortIndex>;
+    std::vector<Source> inputs, outputs;
+    auto subGraph = std::make_unique<CustomGraph>(BlockManager::getRegistry(), m_interner);
+    // the ports of the composite take their types from the blocks inside
+    subGraph->setUIDManager(uidManager());
+    QPointF position;
+    {
+        Batch batch(*subGraph);
+        for (const auto &nodeId : nodeIds) {
+            subGraph->loadNode(saveNode(nodeId));
+            position += nodeData(nodeId, QtNodes::NodeRole::Position).toPointF();
+        }
+        for (const auto &connectionId : internal)
+            subGraph->addConnection(connectionId);
+        std::map<Source, QtNodes::NodeId> inputNodes;
+        for (const auto &connectionId : incoming) {
+            Source source{connectionId.outNodeId, connectionId.outPortIndex};
+            auto found = inputNodes.find(source);
+            if (found == inputNodes.end()) {
+                auto inputId = subGraph->addNode(composite_names::INPUT);
+                found = inputNodes.emplace(source, inputId).first;
+                inputs.push_back(source);
+            }
+            subGraph->addConnection(
+                {found->second, 0, connectionId.inNodeId, connectionId.inPortIndex});
+        }
+        std::map<Source, QtNodes::NodeId> outputNodes;
+        for (const auto &connectionId : outgoing) {
+            Source source{connectionId.outNodeId, connectionId.outPortIndex};
+            if (outputNodes.count(source) > 0)
+                continue;
+            auto outputId = subGraph->addNode(composite_names::OUTPUT);
+            subGraph->delegateModel<FdfBlockModel>(outputId)->setCaption(
+                delegateModel<FdfBlockModel>(source.first)->portCaption(PortType::Out,
+                                                                        source.second));
+            subGraph->addConnection({source.first, source.second, outputId, 0});
+            outputNodes.emplace(source, outputId);
+            outputs.push_back(source);
+        }
+    }
+
+    QtNodes::NodeId compositeId;
+    CompositeModel *composite;
+    {
+        Batch batch(*this);
+        compositeId = addNode(composite_names::COMPOSITE);
+        setNodeData(compositeId, QtNodes::NodeRole::Position, position / nodeIds.size());
+        composite = delegateModel<CompositeModel>(compositeId);
+        composite->setSubGraph(std::move(subGraph));
+        for (const auto &nodeId : nodeIds)
+            deleteNode(nodeId);
+        for (PortIndex i = 0; i < inputs.size(); ++i)
+            addConnection({inputs.at(i).first, inputs.at(i).second, compositeId, i});
+        for (const auto &connectionId : outgoing) {
+            Source source{connectionId.outNodeId, connectionId.outPortIndex};
+            PortIndex index = std::find(outputs.begin(), outputs.end(), source) - outputs.begin();
+            addConnection({compositeId, index, connectionId.inNodeId, connectionId.inPortIndex});
+        }
+    }
+    // the inputs have reached the blocks inside once the batch committed, the blocks are only
+    // built again when the composite is edited
+    composite->collapse();
+    return compositeId;
+}
@@ -0,0 +1,136 @@
+#include "data/graph_layout.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+using QtNodes::NodeId;
+
+// dense indices so the sweeps work on vectors rather than hash maps
+struct IndexedGraph
+{
+    std::vector<std::vector<size_t>> successors;
+    std::vector<std::vector<size_t>> predecessors;
+};
+
+IndexedGraph indexGraph(const data::LayoutGraph &graph)
+{
+    std::unordered_map<NodeId, size_t> index;
+    index.reserve(graph.nodes.size());
+    for (size_t i = 0; i < graph.nodes.size(); ++i)
+        index.emplace(graph.nodes.at(i), i);
+    IndexedGraph result;
+    result.successors.resize(graph.nodes.size());
+    result.predecessors.resize(graph.nodes.size());
+    for (const auto &edge : graph.edges) {
+        auto from = index.find(edge.first);
+        auto to = index.find(edge.second);
+        if (from == index.end() || to == index.end() || from->second == to->second)
+            continue;
+        result.successors.at(from->second).push_back(to->second);
+        result.predecessors.at(to->second).push_back(from->second);
+    }
+    return result;
+}
+
+// longest path from a source, in topological order
+std::vector<size_t> assignLayers(const IndexedGraph &graph)
+{
+    const size_t count = graph.successors.size();
+    std::vector<size_t> layers(count, 0);
+    std::vector<size_t> inDegree(count);
+    std::vector<size_t> queue;
+    queue.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        if ((inDegree.at(i) = graph.predecessors.at(i).size()) == 0)
+            queue.push_back(i);
+    for (size_t next = 0; next < queue.size(); ++next) {
+        auto node = queue.at(next);
+        for (auto successor : graph.successors.at(node)) {
+            layers.at(successor) = std::max(layers.at(successor), layers.at(node) + 1);
+            if (--inDegree.at(successor) == 0)
+                queue.push_back(successor);
+        }
+    }
+    return layers;
+}
+
+// reorders the layers by the mean position of the neighbours in the already ordered layers
+void sweep(std::vector<std::vector<size_t>> &order,
+           std::vector<double> &position,
+           const std::vector<std::vector<size_t>> &neighbours,
+           bool forward)
+{
+    const size_t layerCount = order.size();
+    std::vector<double> barycenter(position.size());
+    for (size_t step = 1; step < layerCount; ++step) {
+        auto &layer = order.at(forward ? step : layerCount - 1 - step);
+        for (auto node : layer) {
+            const auto &adjacent = neighbours.at(node);
+            if (adjacent.empty()) {
+                // keeps its place relative to the others
+                barycenter.at(node) = position.at(node);
+                continue;
+            }
+            double sum = 0;
+            for (auto other : adjacent)
+                sum += position.at(other);
+            barycenter.at(node) = sum / adjacent.size();
+        }
+        std::stable_sort(layer.begin(), layer.end(), [&barycenter](size_t a, size_t b) {
+            return barycenter.at(a) < barycenter.at(b);
+        });
+        for (size_t i = 0; i < layer.size(); ++i)
+            position.at(layer.at(i)) = i;
+    }
+}
+
+} // namespace
+
+namespace data {
+
+std::unordered_map<QtNodes::NodeId, QPointF> LayeredLayout::compute(const LayoutGraph &graph)
+{
+    std::unordered_map<QtNodes::NodeId, QPointF> result;
+    if (graph.nodes.empty())
+        return result;
+    auto indexed = indexGraph(graph);
+    auto layers = assignLayers(indexed);
+
+    const size_t layerCount = *std::max_element(layers.begin(), layers.end()) + 1;
+    std::vector<std::vector<size_t>> order(layerCount);
+    std::vector<double> position(graph.nodes.size());
+    for (size_t i = 0; i < graph.nodes.size(); ++i) {
+        auto &layer = order.at(layers.at(i));
+        position.at(i) = layer.size();
+        layer.push_back(i);
+    }
+    // neighbours are only counted in the layers already placed by the sweep
+    for (int i = 0; i < SWEEPS; ++i)
+        sweep(order, position, i % 2 == 0 ? indexed.predecessors : indexed.successors, i % 2 == 0);
+
+    auto sizeOf = [&graph](size_t node) {
+        auto size = graph.sizes.find(graph.nodes.at(node));
+        return size == graph.sizes.end() ? QSizeF() : size->second;
+    };
+    result.reserve(graph.nodes.size());
+    double x = 0;
+    for (const auto &layer : order) {
+        double width = 0;
+        double height = 0;
+        for (auto node : layer) {
+            width = std::max(width, sizeOf(node).width());
+            height += sizeOf(node).height() + NODE_SPACING;
+        }
+        // centered on y = 0
+        double y = -height / 2;
+        for (auto node : layer) {
+            result.emplace(graph.nodes.at(node), QPointF(x, y));
+            y += sizeOf(node).height() + NODE_SPACING;
+        }
+        x += width + LAYER_SPACING;
+    }
+    return result;
+}
+
+} // namespace data
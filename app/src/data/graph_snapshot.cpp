@@ -0,0 +1,50 @@
+#include "data/graph_snapshot.hpp"
+
+#include "ui/models/composite_model.hpp"
+
+std::shared_ptr<const NodeSnapshot> NodeSnapshot::fromBlock(QtNodes::NodeId id,
+                                                            const FdfBlockModel &block)
+{
+    auto result = std::make_shared<NodeSnapshot>();
+    result->id = id;
+    result->type = block.type();
+    result->typeString = block.typeAsString();
+    result->name = block.name();
+    result->functionName = block.functionName();
+    result->caption = block.caption();
+    for (PortIndex i = 0; i < block.nPorts(PortType::In); ++i)
+        if (auto port = block.portData(PortType::In, i))
+            result->inputs.append(port->type().name);
+    for (PortIndex i = 0; i < block.nPorts(PortType::Out); ++i) {
+        auto port = block.outPort<NamedNode>(i);
+        if (!port)
+            continue;
+        result->outputs.append(port->type().name);
+        auto descriptor = port->descriptor();
+        auto function = block.outPort<FunctionNode>(i);
+        result->outPorts.push_back({port->type().name,
+                                    descriptor.kind,
+                                    descriptor.typeId,
+                                    function ? function->signature() : Signature(),
+                                    port->persistence()});
+    }
+    result->hasParameters = block.hasParameters();
+    auto values = block.getParameters();
+    for (const auto &parameter : block.getParameterSchema()) {
+        auto value = values.find(*parameter.key);
+        if (value != values.end())
+            result->parameters.emplace_back(value->first, value->second);
+    }
+    if (block.name() == composite_names::COMPOSITE) {
+        auto &composite = static_cast<const CompositeModel &>(block);
+        result->pipeline = composite.pipelineSnapshot();
+        result->fingerprint = composite.fingerprint();
+    }
+    return result;
+}
+
+const NodeSnapshot *GraphSnapshot::node(QtNodes::NodeId id) const
+{
+    auto it = nodes.find(id);
+    return it == nodes.end() ? nullptr : it->second.get();
+}
@@ -0,0 +1,145 @@
+#include "data/h5_browser.hpp"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <algorithm>
+
+#include "logging_categories.hpp"
+
+#ifdef DESCARTES_WITH_HDF5
+#include <hdf5.h>
+#endif
+
+namespace data {
+
+namespace {
+
+#ifdef DESCARTES_WITH_HDF5
+struct VisitState
+{
+    std::vector<H5DatasetInfo> datasets;
+    // MATLAB stores axes in column-major order, mat73 transposes them back on load
+    bool reverseAxes = false;
+};
+
+QString typeClassName(H5T_class_t typeClass)
+{
+    switch (typeClass) {
+    case H5T_INTEGER:
+        return "integer";
+    case H5T_FLOAT:
+        return "float";
+    case H5T_STRING:
+        return "string";
+    case H5T_COMPOUND:
+        return "compound";
+    case H5T_REFERENCE:
+        return "reference";
+    case H5T_ENUM:
+        return "enum";
+    case H5T_ARRAY:
+        return "array";
+    default:
+        return "other";
+    }
+}
+
+herr_t visitLink(hid_t group, const char *name, const H5L_info_t *info, void *data)
+{
+    auto state = static_cast<VisitState *>(data);
+    // skip soft/external links and MATLAB bookkeeping groups
+    if (info->type != H5L_TYPE_HARD || name[0] == '#')
+        return 0;
+    hid_t object = H5Oopen(group, name, H5P_DEFAULT);
+    if (object < 0)
+        return 0;
+    if (H5Iget_type(object) == H5I_DATASET) {
+        H5DatasetInfo dataset;
+        dataset.path = '/' + QString::fromUtf8(name);
+
+        hid_t space = H5Dget_space(object);
+        int rank = H5Sget_simple_extent_ndims(space);
+        if (rank > 0) {
+            std::vector<hsize_t> dims(rank);
+            H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+            dataset.shape.assign(dims.begin(), dims.end());
+            if (state->reverseAxes)
+                std::reverse(dataset.shape.begin(), dataset.shape.end());
+        }
+        H5Sclose(space);
+
+        hid_t type = H5Dget_type(object);
+        dataset.typeClass = typeClassName(H5Tget_class(type));
+        H5Tclose(type);
+
+        state->datasets.push_back(dataset);
+    }
+    H5Oclose(object);
+    return 0;
+}
+#endif
+
+} // namespace
+
+bool H5Browser::isAvailable()
+{
+#ifdef DESCARTES_WITH_HDF5
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<H5DatasetInfo> H5Browser::listDatasets(const QString &filePath)
+{
+#ifdef DESCARTES_WITH_HDF5
+    VisitState state;
+    QByteArray path = filePath.toLocal8Bit();
+    if (H5Fis_hdf5(path.constData()) <= 0) {
+        qCWarning(lcIo) << "Not an HDF5 file:" << filePath;
+        return state.datasets;
+    }
+    // the library prints its error stack on failures, we report them ourselves
+    H5E_auto2_t errorHandler;
+    void *errorData;
+    H5Eget_auto2(H5E_DEFAULT, &errorHandler, &errorData);
+    H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+
+    hid_t file = H5Fopen(path.constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file >= 0) {
+        state.reverseAxes = QFileInfo(filePath).suffix().compare("mat", Qt::CaseInsensitive) == 0;
+        H5Lvisit(file, H5_INDEX_NAME, H5_ITER_INC, visitLink, &state);
+        H5Fclose(file);
+    } else {
+        qCWarning(lcIo) << "Cannot open HDF5 file:" << filePath;
+    }
+    H5Eset_auto2(H5E_DEFAULT, errorHandler, errorData);
+    return state.datasets;
+#else
+    Q_UNUSED(filePath);
+    return {};
+#endif
+}
+
+std::optional<std::pair<quint64, std::optional<quint64>>> H5Browser::parseRange(
+    const QString &range)
+{
+    auto bounds = range.split(':');
+    if (bounds.size() != 2)
+        return std::nullopt;
+    bool ok = true;
+    quint64 start = 0;
+    if (!bounds[0].trimmed().isEmpty())
+        start = bounds[0].trimmed().toULongLong(&ok);
+    if (!ok)
+        return std::nullopt;
+    std::optional<quint64> stop;
+    if (!bounds[1].trimmed().isEmpty()) {
+        stop = bounds[1].trimmed().toULongLong(&ok);
+        if (!ok || stop.value() <= start)
+            return std::nullopt;
+    }
+    return std::make_pair(start, stop);
+}
+
+} // namespace data
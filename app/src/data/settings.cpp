@@ -1,11 +1,16 @@
 #include "data/settings.hpp"
 
+#include "logging_categories.hpp"
+
 namespace {
 
 const std::map<QString, QVariant> DEFAULT_VALUES = {
     {"engine", "kedro"},
     {"engine timeout (minutes)", 5},
     {"default export format", ".dcb (Graph + data)"},
+    {"opengl viewport", false},
+    // subsystems whose debug output is logged, see logging_categories.hpp
+    {"debug log subsystems", QStringList()},
 };
 
 }
@@ -46,7 +51,7 @@ QVariant Settings::value(const QString &key) const
 void Settings::printAll() const
 {
     for (auto &pair : DEFAULT_VALUES)
-        qDebug() << pair.first << ": " << value(pair.first);
+        qCDebug(lcUi) << pair.first << ": " << value(pair.first);
 }
 
 } // namespace data
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "data/string_interner.hpp"
+#include <QDebug>
+
+#include "logging_categories.hpp"
+
+StringInterner::StringInterner()
+{
+    intern(QString());
+}
+
+Atom StringInterner::intern(const QString &string)
+{
+    auto existing = m_atoms.find(string);
+    if (existing != m_atoms.end())
+        return existing->second;
+    Atom atom = m_strings.size();
+    m_strings.push_back(string);
+    m_atoms.emplace(m_strings.back(), atom);
+    return atom;
+}
+
+Atom StringInterner::find(const QString &string) const
+{
+    auto existing = m_atoms.find(string);
+    return existing == m_atoms.end() ? NO_ATOM : existing->second;
+}
+
+const QString &StringInterner::string(Atom atom) const
+{
+    if (atom >= m_strings.size()) {
+        qCWarning(lcGraph) << "Unknown atom" << atom;
+        return m_strings.front();
+    }
+    return m_strings[atom];
+}
@@ -1,19 +1,27 @@
 #include "data/tab_components.hpp"
 #include "data/tab_manager.hpp"
+#include <QAction>
 #include <QDebug>
 #include <QFileDialog>
+#include <QGraphicsSceneMouseEvent>
 #include <QJsonArray>
 #include <QMessageBox>
+#include <QOpenGLWidget>
 #include <QStandardPaths>
 
+#include <QtNodes/ConnectionGraphicsObject>
 #include <QtNodes/DagGraphicsScene>
 #include <QtNodes/DirectedAcyclicGraphModel>
 #include <QtNodes/GraphicsView>
+#include <QtNodes/NodeGraphicsObject>
 
 #include <quazip/JlCompress.h>
 
 #include "data/block_manager.hpp"
 #include "data/custom_graph.hpp"
+#include "data/settings.hpp"
+#include "logging_categories.hpp"
+#include "ui/lod_node_painter.hpp"
 #include "ui/models/io_models.hpp"
 
 using QtNodes::DagGraphicsScene;
@@ -26,28 +34,46 @@ const QString FILE_EXTENSION = "dcb";
 } // namespace
 
 TabComponents::TabComponents(QWidget *parent, std::optional<QFileInfo> fileInfo)
-    : m_graph(new CustomGraph(BlockManager::getRegistry()))
+    : m_interner(std::make_shared<StringInterner>())
+    , m_graph(new CustomGraph(BlockManager::getRegistry(), m_interner))
     , m_scene(new DagGraphicsScene(*m_graph, parent))
     , m_view(new GraphicsView(m_scene))
     , m_dir(std::make_shared<QTemporaryDir>())
     , m_dataDir(m_dir->filePath("data"))
-    , m_uidManager(std::make_unique<UIDManager>())
+    , m_uidManager(std::make_unique<UIDManager>(m_interner))
 {
     // this is needed to keep the temp dir alive to avoid race condition during unit tests. This will eventually get deleted later by the os
     m_dir->setAutoRemove(false);
     m_graph->setParent(parent);
     if (!m_dir->isValid())
-        qCritical() << "Temp dir failed to init";
+        qCCritical(lcIo) << "Temp dir failed to init";
     m_dataDir.mkpath(".");
+    m_graph->attachScene(m_scene);
+    setupRendering();
     // Qt bug for MacOS throws warnings when using touch pad with graphics view
     // touch pad seems to trigger touch events, so touch events are disabled to supress the bug
     m_view->viewport()->setAttribute(Qt::WA_AcceptTouchEvents, false);
     m_uidManager->setGraph(m_graph);
+    m_graph->setUIDManager(m_uidManager.get());
     connect(m_graph,
             &DirectedAcyclicGraphModel::graphLoadedFromFile,
             this,
             &TabComponents::postLoadProcess);
-    connect(m_scene, &DagGraphicsScene::sceneLoaded, m_view, &GraphicsView::centerScene);
+    // the file is loaded in a batch, the items only exist once it committed
+    connect(m_scene,
+            &DagGraphicsScene::sceneLoaded,
+            m_view,
+            &GraphicsView::centerScene,
+            Qt::QueuedConnection);
+    // a paste adds many blocks, the view selects their items right after adding each
+    for (auto action : m_view->actions())
+        if (action->shortcut() == QKeySequence(QKeySequence::Paste)) {
+            disconnect(action, &QAction::triggered, m_view, &GraphicsView::onPasteObjects);
+            connect(action, &QAction::triggered, this, [this]() {
+                CustomGraph::Batch batch(*m_graph, CustomGraph::Batch::KeepScene);
+                m_view->onPasteObjects();
+            });
+        }
     if (parent)
         QObject::connect(m_scene, &DagGraphicsScene::modified, parent, [parent]() {
             parent->setWindowModified(true);
@@ -61,10 +87,91 @@ TabComponents::TabComponents(QWidget *parent, std::optional<QFileInfo> fileInfo)
     }
 }
 
+void TabComponents::setupRendering()
+{
+    m_scene->setNodePainter(std::make_unique<LodNodePainter>());
+    m_view->setOptimizationFlags(QGraphicsView::DontSavePainterState
+                                 | QGraphicsView::DontAdjustForAntialiasing);
+    if (data::Settings::instance().value("opengl viewport").toBool()) {
+        m_view->setViewport(new QOpenGLWidget());
+        // partial updates are not supported by a gl viewport
+        m_view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    }
+    connect(m_view, &GraphicsView::scaleChanged, this, &TabComponents::onViewScaleChanged);
+    // block content is painted, presses on it are routed to the block from here
+    m_scene->installEventFilter(this);
+    // short connection paths are only recomputed when an end moves, not on every pan
+    connect(m_graph,
+            &CustomGraph::sceneConnectionCreated,
+            this,
+            &TabComponents::updateConnectionCache);
+    connect(m_graph,
+            &CustomGraph::nodePositionUpdated,
+            this,
+            [this](const QtNodes::NodeId nodeId) {
+                for (const auto &connectionId : m_graph->allConnectionIds(nodeId))
+                    updateConnectionCache(connectionId);
+            });
+}
+
+void TabComponents::updateConnectionCache(const QtNodes::ConnectionId connectionId)
+{
+    auto item = m_scene->connectionGraphicsObject(connectionId);
+    if (!item)
+        return;
+    item->setCacheMode(LodNodePainter::cacheConnection(item->boundingRect(), m_scale)
+                           ? QGraphicsItem::DeviceCoordinateCache
+                           : QGraphicsItem::NoCache);
+}
+
+void TabComponents::onViewScaleChanged(double scale)
+{
+    m_lowDetail = scale < LodNodePainter::FULL_DETAIL;
+    m_scale = scale;
+    // the cached pixmaps grow with the scale
+    for (const auto &nodeId : m_graph->allNodeIds())
+        for (const auto &connectionId : m_graph->allConnectionIds(nodeId))
+            if (connectionId.outNodeId == nodeId)
+                updateConnectionCache(connectionId);
+}
+
+bool TabComponents::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_scene && event->type() == QEvent::GraphicsSceneMousePress) {
+        auto mouseEvent = static_cast<QGraphicsSceneMouseEvent *>(event);
+        if (mouseEvent->button() == Qt::LeftButton && pressContent(mouseEvent->scenePos()))
+            return true;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+bool TabComponents::pressContent(const QPointF &scenePos)
+{
+    if (m_lowDetail)
+        return false;
+    for (auto item : m_scene->items(scenePos)) {
+        auto node = qgraphicsitem_cast<QtNodes::NodeGraphicsObject *>(item);
+        if (!node)
+            continue;
+        // only the topmost block under the cursor
+        auto block = m_graph->delegateModel<FdfBlockModel>(node->nodeId());
+        if (!block || block->contentSize().isEmpty())
+            return false;
+        auto rect = block->contentRect(m_scene->nodeGeometry().size(node->nodeId()));
+        auto position = node->mapFromScene(scenePos);
+        if (!rect.contains(position))
+            return false;
+        return block->contentPressed(position - rect.topLeft(), rect.size());
+    }
+    return false;
+}
+
 TabComponents::~TabComponents()
 {
     m_view->deleteLater();
     m_scene->deleteLater();
+    // the manager goes with the tab, the blocks deleted later fall back to the graph's own
+    m_graph->setUIDManager(nullptr);
     m_graph->deleteLater();
 }
 
@@ -76,7 +183,7 @@ bool TabComponents::save()
         return false;
     if (!JlCompress::compressDir(m_localFile.absoluteFilePath(), m_dataDir.absolutePath()))
         return false;
-    qInfo() << "File saved to: " << m_localFile.absoluteFilePath();
+    qCInfo(lcIo) << "File saved to: " << m_localFile.absoluteFilePath();
     return true;
 }
 
@@ -126,16 +233,17 @@ bool TabComponents::open()
 bool TabComponents::openExisting()
 {
     if (m_localFile.filePath().isEmpty()) {
-        qWarning() << "File path is empty";
+        qCWarning(lcIo) << "File path is empty";
         return false;
     }
 
     JlCompress::extractDir(m_localFile.absoluteFilePath(), m_dataDir.absolutePath());
     if (!m_dataDir.exists(m_localFile.baseName() + SCENE_EXTENSION)) {
-        qWarning() << "Scene file does not exist: "
-                   << m_dataDir.absoluteFilePath(m_localFile.baseName() + SCENE_EXTENSION);
+        qCWarning(lcIo) << "Scene file does not exist: "
+                        << m_dataDir.absoluteFilePath(m_localFile.baseName() + SCENE_EXTENSION);
         return false;
     }
+    CustomGraph::Batch batch(*m_graph);
     return m_scene->load(m_dataDir.absoluteFilePath(m_localFile.baseName() + SCENE_EXTENSION));
 }
 
@@ -161,7 +269,7 @@ void TabComponents::onDataSourceImportClicked(const QtNodes::NodeId nodeId)
                                      tr("data (*%1)").arg(DataSourceModel::fileFilter())));
     if (originalFile.filePath().isEmpty() || originalFile.suffix().isEmpty())
         return; // cancelled
-    qDebug() << "copy to: " << m_dataDir.absoluteFilePath(originalFile.fileName());
+    qCDebug(lcIo) << "copy to: " << m_dataDir.absoluteFilePath(originalFile.fileName());
     QFileInfo newFile(m_dataDir.absoluteFilePath(originalFile.fileName()));
     // move to temp dir
     QFile::copy(originalFile.absoluteFilePath(), newFile.absoluteFilePath());
@@ -173,10 +281,10 @@ void TabComponents::onDataSourceImportClicked(const QtNodes::NodeId nodeId)
 
 void TabComponents::postLoadProcess(const QJsonArray &nodesJsonArray)
 {
-    // This function is called after the graph is loaded from a file. It reloads the type tags
-    // and annotations for the output ports of the nodes based on the saved JSON data.
+    // This function is called after the graph is loaded from a file. It reloads the type tags,
+    // annotations and persistence of the output ports of the nodes based on the saved JSON data.
     if (nodesJsonArray.isEmpty()) {
-        qWarning() << "No nodes found in the loaded graph.";
+        qCWarning(lcIo) << "No nodes found in the loaded graph.";
         return;
     }
 
@@ -192,10 +300,11 @@ void TabComponents::postLoadProcess(const QJsonArray &nodesJsonArray)
         return QJsonObject();
     };
 
+    CustomGraph::Batch batch(*m_graph);
     for (const auto &id : m_graph->allNodeIds()) {
         QJsonObject nodeJson = findById(nodesJsonArray, id);
         if (nodeJson.isEmpty()) {
-            qWarning() << "Node with ID" << id << "not found in the loaded graph.";
+            qCWarning(lcIo) << "Node with ID" << id << "not found in the loaded graph.";
             continue;
         }
         auto block = m_graph->delegateModel<FdfBlockModel>(id);
@@ -209,17 +318,19 @@ void TabComponents::postLoadProcess(const QJsonArray &nodesJsonArray)
             int index = portJson["index"].toInt();
 
             if (index >= 0 && static_cast<size_t>(index) < block->nPorts(PortType::Out)) {
-                if (auto port = std::dynamic_pointer_cast<DataNode>(block->outData(index))) {
+                if (auto port = block->outPort<DataNode>(index)) {
                     port->setAnnotation(portJson["annotation"].toString());
                     port->setTypeTagName(portJson["type_tag"].toString());
                     // Ensure output ports have unique captions after loading
                     Q_EMIT block->outPortCaptionUpdated(index, port->name());
-                } else if (auto port = std::dynamic_pointer_cast<FunctionNode>(
-                               block->outData(index))) {
+                } else if (auto port = block->outPort<FunctionNode>(index)) {
                     port->setName(portJson["caption"].toString());
                     // Ensure output ports have unique captions after loading
                     Q_EMIT block->outPortCaptionUpdated(index, port->name());
                 }
+                if (auto port = block->outPort<NamedNode>(index))
+                    if (portJson.contains("persistence"))
+                        port->setPersistence(portJson["persistence"].toString());
             }
         }
     }
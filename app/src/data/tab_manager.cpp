@@ -6,6 +6,7 @@
 #include <QtNodes/GraphicsView>
 
 #include "data/custom_graph.hpp"
+#include "ui/models/fdf_block_model.hpp"
 #include "ui/models/uid_manager.hpp"
 
 using QtNodes::DagGraphicsScene;
@@ -29,6 +30,19 @@ std::shared_ptr<TabComponents> TabManager::getTab(QWidget *view) const
     return m_tabs.at(view);
 }
 
+std::shared_ptr<TabComponents> TabManager::getTab(const FdfBlockModel *block) const
+{
+    if (!block)
+        return nullptr;
+    for (auto &pair : m_tabs) {
+        auto graph = pair.second->getGraph();
+        if (graph && graph->nodeExists(block->nodeId())
+            && graph->delegateModel<FdfBlockModel>(block->nodeId()) == block)
+            return pair.second;
+    }
+    return nullptr;
+}
+
 CustomGraph *TabManager::currentGraph() const
 {
     if (auto tab = getCurrentTab())
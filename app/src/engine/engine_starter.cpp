@@ -4,12 +4,13 @@
 #include "engine/kedro.hpp"
 
 #include "data/settings.hpp"
+#include "logging_categories.hpp"
 
 std::unique_ptr<AbstractEngine> EngineStarter::init()
 {
     auto engine = data::Settings::instance().value("engine").toString().toLower();
     if (engine == "kedro")
         return std::make_unique<Kedro>();
-    qWarning() << "Engine can't be found, defaulting to Kedro";
+    qCWarning(lcEngine) << "Engine can't be found, defaulting to Kedro";
     return std::make_unique<Kedro>();
 }
\ No newline at end of file
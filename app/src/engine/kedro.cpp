@@ -1,7 +1,9 @@
 #include "engine/kedro.hpp"
 
+#include <functional>
 #include <QApplication>
 #include <QProcess>
+#include <QSet>
 #include <QStandardPaths>
 
 #include <QtNodes/DirectedAcyclicGraphModel>
@@ -13,8 +15,11 @@
 
 #include "data/constants.hpp"
 #include "data/custom_graph.hpp"
+#include "data/graph_snapshot.hpp"
 #include "data/settings.hpp"
 #include "data/tab_components.hpp"
+#include "logging_categories.hpp"
+#include "ui/models/composite_model.hpp"
 #include "ui/models/fdf_block_model.hpp"
 #include "ui/models/io_models.hpp"
 #include "ui/models/processor_models.hpp"
@@ -45,17 +50,95 @@ QString quote(const QString &string)
     return '\"' + string + '\"';
 }
 
-QStringList getPortList(const FdfBlockModel &block, const PortType &type)
+QStringList quoteAll(const QStringList &names)
 {
     QStringList result;
-    for (PortIndex i = 0; i < block.nPorts(type); ++i) {
-        // if an in port is not connected it is null, the 'if' can be removed after the validity check handles it
-        if (auto port = block.portData(type, i))
-            result.append(quote(port->type().name));
+    for (const auto &name : names)
+        result.append(quote(name));
+    return result;
+}
+
+// joblib/zlib level, a middle ground between write speed and size
+constexpr int COMPRESSED_PICKLE_LEVEL = 3;
+
+// catalog entry of an intermediate output port named as kedro sees it, empty if kedro should
+// decide
+QString intermediateCatalogEntry(const PortSnapshot &port, const QString &name)
+{
+    using Persistence = NamedNode::Persistence;
+    const auto path = constants::kedro::INTERMEDIATE_PATH + name;
+    switch (port.persistence) {
+    case Persistence::Memory:
+        return constants::kedro::CATALOG_YML_MEMORY_ENTRY.arg(name);
+    case Persistence::Pickle:
+        return constants::kedro::CATALOG_YML_ENTRY.arg(name, "pickle.PickleDataset", path + ".pkl");
+    case Persistence::Parquet:
+        return constants::kedro::CATALOG_YML_ENTRY.arg(name,
+                                                       "pandas.ParquetDataset",
+                                                       path + ".parquet");
+    case Persistence::CompressedPickle:
+        return constants::kedro::CATALOG_YML_ENTRY.arg(name, "pickle.PickleDataset", path + ".pkl")
+               + constants::kedro::CATALOG_YML_JOBLIB_ARGS.arg(
+                   QString::number(COMPRESSED_PICKLE_LEVEL));
+    case Persistence::Default:
+    default:
+        return QString();
     }
+}
+
+// nested mapping appended to a catalog entry, e.g. load_args
+QString catalogArgs(const QString &key, const std::vector<std::pair<QString, QString>> &args)
+{
+    if (args.empty())
+        return QString();
+    QString result = key + ":\n";
+    for (auto &pair : args)
+        result += QString("    %1: %2\n").arg(pair.first, pair.second);
+    return result + "  ";
+}
+
+// file name of an output block, pickles streamed through a codec carry its suffix
+QString outputFileName(const OutputModel &output)
+{
+    QString result = output.getFileName() + '.' + output.getFileExtenstion();
+    if (output.getFileType() == CatalogType::Pickle)
+        switch (output.getCodec()) {
+        case Codec::Lz4:
+            return result + ".lz4";
+        case Codec::Zstd:
+            return result + ".zst";
+        default:
+            break;
+        }
     return result;
 }
 
+// catalog arguments for the codec of an output block
+QString compressionArgs(const OutputModel &output)
+{
+    switch (output.getFileType()) {
+    case CatalogType::Parquet:
+    case CatalogType::Feather:
+        if (output.getCodec() == Codec::Uncompressed)
+            return constants::kedro::CATALOG_YML_UNCOMPRESSED_ARGS.arg(
+                output.getFileType() == CatalogType::Parquet ? "none" : "uncompressed");
+        // arrow compresses per column chunk, the level is honoured
+        return constants::kedro::CATALOG_YML_COMPRESSION_ARGS
+            .arg(output.codecString(), QString::number(output.getCompressionLevel()));
+    case CatalogType::Pickle:
+        if (output.getCodec() == Codec::Uncompressed)
+            return QString();
+        // the pickle stream is compressed by fsspec with the codec's default level
+        return constants::kedro::CATALOG_YML_STREAM_COMPRESSION_ARGS.arg(output.codecString());
+    default:
+        if (output.getCodec() == Codec::Uncompressed)
+            return QString();
+        qCWarning(lcEngine) << "Compression is not supported for" << output.fileTypeString() << ","
+                            << output.getFileName() << "is written uncompressed";
+        return QString();
+    }
+}
+
 QString getPythonExecutable()
 {
     /*
@@ -68,12 +151,12 @@ QString getPythonExecutable()
     baseDir.cdUp(); // Go to the parent directory of the application dir
     QString pythonExec = baseDir.filePath("python_win\\python.exe");
 
-    qDebug() << "Checking for Python executable at:" << pythonExec;
+    qCDebug(lcEngine) << "Checking for Python executable at:" << pythonExec;
     if (QFile::exists(pythonExec)) {
-        qInfo() << "Using Python executable from python:" << pythonExec;
+        qCInfo(lcEngine) << "Using Python executable from python:" << pythonExec;
         return pythonExec;
     }
-    qInfo() << "Using system Python executable";
+    qCInfo(lcEngine) << "Using system Python executable";
     return QString("python"); // Fallback to system Python
 }
 
@@ -88,27 +171,28 @@ QDir getKedroUmbrellaDir(QString const &pythonExecutable)
 
     QString kedroUmbrellaPath = process.readAllStandardOutput().trimmed();
     if (kedroUmbrellaPath.isEmpty()) {
-        qCritical() << "Failed to locate kedro-umbrella package";
+        qCCritical(lcEngine) << "Failed to locate kedro-umbrella package";
         throw std::runtime_error("Failed to locate kedro-umbrella package");
     }
-    qInfo() << "Using kedro_umbrella path :" << kedroUmbrellaPath;
+    qCInfo(lcEngine) << "Using kedro_umbrella path :" << kedroUmbrellaPath;
     return QDir(kedroUmbrellaPath);
 }
 
-QString toString(const FdfBlockModel &block)
+QString toString(const NodeSnapshot &block)
 {
-    QString result = block.typeAsString() + '(';
-    if (!block.functionName().isEmpty())
-        result += QString("func=%1,").arg(block.functionName());
-    result += QString("name=%1").arg(quote(block.caption()));
-    QStringList inputs = getPortList(block, PortType::In);
-    if (block.hasParameters())
-        inputs << quote(QString("params:%1").arg(block.caption()));
+    QString result = block.typeString + '(';
+    if (!block.functionName.isEmpty())
+        result += QString("func=%1,").arg(block.functionName);
+    result += QString("name=%1").arg(quote(block.caption));
+    // unconnected in ports are not in the snapshot, the validity check rejects them anyway
+    QStringList inputs = quoteAll(block.inputs);
+    if (block.hasParameters)
+        inputs << quote(QString("params:%1").arg(block.caption));
     if (inputs.size() == 1)
         result += QString(",inputs=%1").arg(inputs.at(0));
     else if (inputs.size() > 1)
         result += QString(",inputs=[%1]").arg(inputs.join(','));
-    QStringList outputs = getPortList(block, PortType::Out);
+    QStringList outputs = quoteAll(block.outputs);
     if (outputs.size() == 1)
         result += QString(",outputs=%1").arg(outputs.at(0));
     else if (outputs.size() > 1)
@@ -117,6 +201,95 @@ QString toString(const FdfBlockModel &block)
     return result;
 }
 
+// blocks with parameters and their values, those of a composite are nested under its caption
+// since kedro prefixes the parameters of a modular pipeline with its namespace
+void appendParameters(QStringList &parameters, const GraphSnapshot &graph, const QString &indent)
+{
+    for (const auto &id : graph.topologicalOrder) {
+        auto block = graph.node(id);
+        if (!block)
+            continue;
+        if (block->pipeline) {
+            QStringList inner;
+            appendParameters(inner, *block->pipeline, indent + "  ");
+            if (!inner.empty())
+                parameters << indent + block->caption + ':' << inner;
+            continue;
+        }
+        // data and output blocks are configured through the catalog instead
+        if (!block->hasParameters || EXCLUDED_TYPES.count(block->type) > 0)
+            continue;
+        parameters << indent + block->caption + ':';
+        for (auto &pair : block->parameters)
+            parameters << QString("%1  %2: %3").arg(indent, pair.first, pair.second);
+    }
+}
+
+// names of the data on the boundary blocks of a sub-pipeline, in port order
+QStringList boundaryNames(const GraphSnapshot &graph, const QString &name)
+{
+    std::map<QtNodes::NodeId, QString> names;
+    for (const auto &pair : graph.nodes) {
+        const auto &block = *pair.second;
+        if (block.name != name)
+            continue;
+        const auto &ports = name == composite_names::INPUT ? block.outputs : block.inputs;
+        names.emplace(pair.first, ports.value(0));
+    }
+    QStringList result;
+    for (const auto &pair : names)
+        result << pair.second;
+    return result;
+}
+
+// kedro dict from the names inside a modular pipeline to the ones outside
+QString namesMapping(const QStringList &inner, const QStringList &outer)
+{
+    QStringList result;
+    for (int i = 0; i < std::min(inner.size(), outer.size()); ++i)
+        result << QString("%1:%2").arg(quote(inner.at(i)), quote(outer.at(i)));
+    return '{' + result.join(',') + '}';
+}
+
+// entries of the intermediate outputs with an explicit persistence policy. Inside a composite,
+// kedro prefixes the names with the namespace of the modular pipeline unless they are mapped to
+// its outputs, resolve gives the name seen by the enclosing pipeline
+void appendIntermediateEntries(QStringList &entries,
+                               const GraphSnapshot &graph,
+                               const QSet<QString> &declaredNames,
+                               const std::function<QString(const QString &)> &resolve)
+{
+    for (const auto &id : graph.topologicalOrder) {
+        auto block = graph.node(id);
+        if (!block || EXCLUDED_TYPES.count(block->type) > 0)
+            continue;
+        if (block->pipeline) {
+            auto inner = boundaryNames(*block->pipeline, composite_names::OUTPUT);
+            std::map<QString, QString> mapped;
+            for (int i = 0; i < std::min(inner.size(), block->outputs.size()); ++i)
+                mapped.emplace(inner.at(i), block->outputs.at(i));
+            const auto prefix = block->caption + '.';
+            appendIntermediateEntries(entries,
+                                      *block->pipeline,
+                                      declaredNames,
+                                      [&](const QString &name) {
+                                          auto found = mapped.find(name);
+                                          return resolve(found != mapped.end() ? found->second
+                                                                               : prefix + name);
+                                      });
+            continue;
+        }
+        for (const auto &port : block->outPorts) {
+            auto name = resolve(port.name);
+            if (declaredNames.contains(name))
+                continue;
+            auto entry = intermediateCatalogEntry(port, name);
+            if (!entry.isEmpty())
+                entries << entry;
+        }
+    }
+}
+
 int timeoutMinutes()
 {
     return Settings::instance().value("engine timeout (minutes)").toInt();
@@ -133,7 +306,7 @@ Kedro::Kedro()
     , m_DEFAULT_TEMPLATE(m_KEDRO_UMBRELLA_DIR.absoluteFilePath("template/builder-spring/"))
 {
     if (!m_runtimeCache.isValid())
-        qCritical() << "Temporary dir failed to setup";
+        qCCritical(lcEngine) << "Temporary dir failed to setup";
     // init execution process
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("COLUMNS", "200");
@@ -157,7 +330,7 @@ Kedro::~Kedro()
 bool Kedro::execute(std::shared_ptr<TabComponents> tab)
 {
     if (m_execution->inProgress) {
-        qInfo() << "There is already an execution in progress, please wait.";
+        qCInfo(lcEngine) << "There is already an execution in progress, please wait.";
         return false;
     }
     emit started();
@@ -171,20 +344,21 @@ bool Kedro::execute(std::shared_ptr<TabComponents> tab)
         return false;
     };
 
-    qDebug() << "Kedro is executing...";
+    qCDebug(lcEngine) << "Kedro is executing...";
     if (!validityCheck(tab))
         return falseAndRelease();
     if (!m_setup) {
-        qCritical() << "Kedro is not setup yet, please setup kedro before executing";
+        qCCritical(lcEngine) << "Kedro is not setup yet, please setup kedro before executing";
         return falseAndRelease();
     }
     m_execution->tab = tab;
     m_execution->project = initWorkspace(tab);
-    if (!generateParametersYml(m_execution->project, tab->getGraph()))
+    auto snapshot = tab->getGraph()->snapshot();
+    if (!generateParametersYml(m_execution->project, *snapshot))
         return falseAndRelease();
-    if (!generateCatalogYml(m_execution->project, tab))
+    if (!generateCatalogYml(m_execution->project, tab, *snapshot))
         return falseAndRelease();
-    if (!generatePipelinePy(m_execution->project, tab->getGraph()))
+    if (!generatePipelinePy(m_execution->project, *snapshot))
         return falseAndRelease();
 
     // call kedro run
@@ -196,21 +370,25 @@ bool Kedro::execute(std::shared_ptr<TabComponents> tab)
 bool Kedro::validityCheck(std::shared_ptr<TabComponents> tab)
 {
     auto graph = tab->getGraph();
-    qInfo() << "Checking graph validity...";
+    qCInfo(lcEngine) << "Checking graph validity...";
     if (graph->isEmpty()) {
-        qWarning() << "There is no blocks in the graph to execute";
+        qCWarning(lcEngine) << "There is no blocks in the graph to execute";
         return false;
     }
-    if (!graph->isConnected()) {
-        qWarning() << "The blocks in the graph are not connected";
+    if (graph->componentCount() > 1) {
+        qCWarning(lcEngine) << "The blocks in the graph are not connected";
         return false;
     }
-    // Add check that every node input is connected
-    if (!graph->verifyBlocksValidity()) {
-        qWarning() << "Some blocks in the graph are not valid, please check the connections";
+    // validity of the blocks is kept up to date by the graph as it is edited
+    if (!graph->allBlocksValid()) {
+        for (const auto &[id, issues] : graph->validityIssues())
+            for (const auto &issue : issues)
+                qCWarning(lcEngine).noquote() << issue;
+        qCWarning(lcEngine)
+            << "Some blocks in the graph are not valid, please check the connections";
         return false;
     }
-    qInfo() << "Passed validity checks!";
+    qCInfo(lcEngine) << "Passed validity checks!";
     return true;
 }
 
@@ -221,35 +399,36 @@ QDir Kedro::initWorkspace(std::shared_ptr<TabComponents> tab)
     QDir kedroDir = ensureDirExists(tab->getTempDir()->filePath("kedro"));
     QDir workspaceDir = QDir(kedroDir.absolutePath() + QDir::separator() + name);
     if (workspaceDir.exists()) {
-        qInfo() << "Workspace already exists: " << workspaceDir.absolutePath();
+        qCInfo(lcEngine) << "Workspace already exists: " << workspaceDir.absolutePath();
         return workspaceDir;
     }
 
-    qInfo() << "Creating workspace " << workspaceDir.absolutePath();
+    qCInfo(lcEngine) << "Creating workspace " << workspaceDir.absolutePath();
     QProcess workspaceProcess;
     workspaceProcess.setWorkingDirectory(kedroDir.absolutePath());
 
     QStringList args = {"-m", "kedro", "new", "-s", m_DEFAULT_TEMPLATE};
-    qInfo() << "Running command:" << m_PYTHON_EXECUTABLE << args;
+    qCInfo(lcEngine) << "Running command:" << m_PYTHON_EXECUTABLE << args;
     workspaceProcess.setProgram(m_PYTHON_EXECUTABLE);
     workspaceProcess.setArguments(args);
     workspaceProcess.start();
 
     if (!workspaceProcess.waitForStarted()) {
-        qCritical() << "Failed to start Kedro process.";
+        qCCritical(lcEngine) << "Failed to start Kedro process.";
         return QDir();
     }
     workspaceProcess.write(name.toUtf8() + '\n');
     workspaceProcess.closeWriteChannel();
     if (!workspaceProcess.waitForFinished()) {
-        qCritical() << "Failed to create workspace " << name;
+        qCCritical(lcEngine) << "Failed to create workspace " << name;
         return QDir();
     }
     if (workspaceProcess.exitStatus() != QProcess::NormalExit || workspaceProcess.exitCode() != 0) {
-        qCritical() << "Workspace creation command failed with exit code "
-                    << workspaceProcess.exitCode();
-        qCritical() << "Command output:\n" << workspaceProcess.readAllStandardOutput();
-        qCritical() << "Command error output:\n" << workspaceProcess.readAllStandardError();
+        qCCritical(lcEngine) << "Workspace creation command failed with exit code "
+                             << workspaceProcess.exitCode();
+        qCCritical(lcEngine) << "Command output:\n" << workspaceProcess.readAllStandardOutput();
+        qCCritical(lcEngine) << "Command error output:\n"
+                             << workspaceProcess.readAllStandardError();
         return QDir();
     }
     return workspaceDir;
@@ -258,14 +437,14 @@ QDir Kedro::initWorkspace(std::shared_ptr<TabComponents> tab)
 void Kedro::onExecutionFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     if (!m_execution->timer.isActive()) {
-        qDebug() << "Execution finished after timeout (minutes): " << timeoutMinutes();
+        qCDebug(lcEngine) << "Execution finished after timeout (minutes): " << timeoutMinutes();
         return;
     }
     m_execution->timer.stop();
     if (exitStatus == QProcess::ExitStatus::CrashExit) {
-        qCritical() << "Failed to run kedro";
+        qCCritical(lcEngine) << "Failed to run kedro";
     } else if (exitCode != 0) {
-        qCritical() << "Kedro process finished with exit code: " << exitCode;
+        qCCritical(lcEngine) << "Kedro process finished with exit code: " << exitCode;
     }
 
     auto output = QString::fromUtf8(m_execution->process.readAllStandardOutput());
@@ -274,7 +453,8 @@ void Kedro::onExecutionFinished(int exitCode, QProcess::ExitStatus exitStatus)
         output += "\nERROR LOG:\n" + QString::fromUtf8(errorOutput);
 
     postExecutionProcess();
-    qDebug() << "Kedro executed, result is stored in: " << m_execution->project.absolutePath();
+    qCDebug(lcEngine) << "Kedro executed, result is stored in: "
+                      << m_execution->project.absolutePath();
     emit executed(output);
     releaseExecution();
     emit finished(true);
@@ -283,37 +463,47 @@ void Kedro::onExecutionFinished(int exitCode, QProcess::ExitStatus exitStatus)
 void Kedro::onTimeOut()
 {
     releaseExecution();
-    qInfo() << "Kedro execution timed out, exceeded limit (minutes): " << timeoutMinutes();
+    qCInfo(lcEngine) << "Kedro execution timed out, exceeded limit (minutes): " << timeoutMinutes();
     emit finished(false);
 }
 
-QString Kedro::serializeNode(const QtNodes::NodeId &id, CustomGraph *graph) const
+QString Kedro::serializeNode(const NodeSnapshot &node)
 {
-    return toString(*graph->delegateModel<FdfBlockModel>(id));
+    if (!node.pipeline)
+        return toString(node);
+    // the inner nodes only depend on the sub-pipeline, composites sharing it reuse them
+    auto cached = m_compositeCode.find(node.fingerprint);
+    if (cached == m_compositeCode.end()) {
+        QStringList innerNodes;
+        for (const auto &id : node.pipeline->topologicalOrder)
+            if (auto block = node.pipeline->node(id))
+                if (EXCLUDED_TYPES.count(block->type) < 1)
+                    innerNodes.append(serializeNode(*block));
+        cached = m_compositeCode.emplace(node.fingerprint, innerNodes.join(",\n")).first;
+    }
+    m_usedCompositeCode.insert(node.fingerprint);
+    return QString("pipeline([%1],inputs=%2,outputs=%3,namespace=%4)")
+        .arg(cached->second,
+             namesMapping(boundaryNames(*node.pipeline, composite_names::INPUT), node.inputs),
+             namesMapping(boundaryNames(*node.pipeline, composite_names::OUTPUT), node.outputs),
+             quote(node.caption));
 }
 
 void Kedro::verifySetup()
 {
     m_setup = true;
-    qInfo() << "Kedro is ready to execute!";
+    qCInfo(lcEngine) << "Kedro is ready to execute!";
 }
 
-bool Kedro::generateParametersYml(const QDir &kedroProject, CustomGraph *graph)
+bool Kedro::generateParametersYml(const QDir &kedroProject, const GraphSnapshot &graph)
 {
     QStringList parameters;
-    for (const auto &id : graph->allNodeIds())
-        if (auto block = graph->delegateModel<FdfBlockModel>(id)) {
-            if (!block->hasParameters())
-                continue;
-            parameters << block->caption() + ':';
-            for (auto &pair : block->getParameters())
-                parameters << QString("  %1: %2").arg(pair.first, pair.second);
-        }
+    appendParameters(parameters, graph, QString());
     QDir conf = ensureDirExists(kedroProject.absoluteFilePath(constants::kedro::CONF_PATH));
     //generate parameters.yml
     QFile parametersYml(conf.absoluteFilePath("parameters.yml"));
     if (!parametersYml.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qCritical() << "Cannot open parameters.yml:" << parametersYml.errorString();
+        qCCritical(lcEngine) << "Cannot open parameters.yml:" << parametersYml.errorString();
         return false;
     }
     QTextStream out(&parametersYml);
@@ -322,13 +512,17 @@ bool Kedro::generateParametersYml(const QDir &kedroProject, CustomGraph *graph)
     return true;
 }
 
-bool Kedro::generateCatalogYml(const QDir &kedroProject, std::shared_ptr<TabComponents> tab)
+bool Kedro::generateCatalogYml(const QDir &kedroProject,
+                               std::shared_ptr<TabComponents> tab,
+                               const GraphSnapshot &graph)
 {
     QDir conf = ensureDirExists(kedroProject.absoluteFilePath(constants::kedro::CONF_PATH));
     auto dataSources = tab->getGraph()->getDataSourceModels();
     QDir rawDataDir = ensureDirExists(
         kedroProject.absoluteFilePath(constants::kedro::RAW_DATA_PATH));
     QStringList catalogEntries;
+    // names declared by data and output blocks, they take precedence over port policies
+    QSet<QString> declaredNames;
     for (auto data : dataSources) {
         auto fileName = data->file().fileName();
         // copy data to raw data dir
@@ -337,25 +531,34 @@ bool Kedro::generateCatalogYml(const QDir &kedroProject, std::shared_ptr<TabComp
         // add external data to catalog.yml
         // Fetch the name of the data port of the datasourcemodel, and
         // for compatibility with kedro, replace spaces with underscores.
+        auto filePath = constants::kedro::yamlQuote(constants::kedro::RAW_DATA_PATH + fileName);
         catalogEntries << constants::kedro::CATALOG_YML_ENTRY.arg(data->outPortCaption(),
                                                                   data->fileTypeString(),
-                                                                  constants::kedro::RAW_DATA_PATH
-                                                                      + fileName);
+                                                                  filePath)
+                              + catalogArgs("load_args", data->loadArgs());
+        declaredNames.insert(data->outPortCaption());
     }
     // add outputs to catalog.yml
-    auto funcOuts = tab->getGraph()->getFuncOutModels();
-    for (auto funcOut : funcOuts) {
-        auto name = funcOut->getFileName();
-        catalogEntries << constants::kedro::CATALOG_YML_ENTRY
-                              .arg(name,
-                                   funcOut->fileTypeString(),
-                                   constants::kedro::MODELS_PATH + name + '.'
-                                       + funcOut->getFileExtenstion());
-    }
+    auto addOutput = [&](const OutputModel &output, const QString &dir) {
+        auto name = output.getFileName();
+        catalogEntries << constants::kedro::CATALOG_YML_ENTRY.arg(name,
+                                                                  output.fileTypeString(),
+                                                                  dir + outputFileName(output))
+                              + compressionArgs(output);
+        declaredNames.insert(name);
+    };
+    for (auto funcOut : tab->getGraph()->getFuncOutModels())
+        addOutput(*funcOut, constants::kedro::MODELS_PATH);
+    for (auto dataOut : tab->getGraph()->getDataOutModels())
+        addOutput(*dataOut, constants::kedro::MODEL_OUTPUT_PATH);
+    // add intermediate outputs that have an explicit persistence policy
+    appendIntermediateEntries(catalogEntries, graph, declaredNames, [](const QString &name) {
+        return name;
+    });
     //generate catalog.yml
     QFile catalogYml(conf.absoluteFilePath("catalog.yml"));
     if (!catalogYml.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qCritical() << "Cannot open catalog.yml:" << catalogYml.errorString();
+        qCCritical(lcEngine) << "Cannot open catalog.yml:" << catalogYml.errorString();
         return false;
     }
     QTextStream out(&catalogYml);
@@ -364,20 +567,24 @@ bool Kedro::generateCatalogYml(const QDir &kedroProject, std::shared_ptr<TabComp
     return true;
 }
 
-bool Kedro::generatePipelinePy(const QDir &kedroProject, CustomGraph *graph)
+bool Kedro::generatePipelinePy(const QDir &kedroProject, const GraphSnapshot &graph)
 {
     // for some reason dir name char '-' will convert to '_'
     QDir source = ensureDirExists(kedroProject.absoluteFilePath(
         QString(constants::kedro::SOURCE_PATH).arg(kedroProject.dirName().replace('-', '_'))));
     QStringList serializedObjects;
-    for (const auto &id : graph->topologicalOrder())
-        if (auto block = graph->delegateModel<FdfBlockModel>(id))
-            if (EXCLUDED_TYPES.count(block->type()) < 1)
-                serializedObjects.append(serializeNode(id, graph));
+    for (const auto &id : graph.topologicalOrder)
+        if (auto block = graph.node(id))
+            if (EXCLUDED_TYPES.count(block->type) < 1)
+                serializedObjects.append(serializeNode(*block));
+    // composites edited or deleted since the previous run are not generated again
+    for (auto it = m_compositeCode.begin(); it != m_compositeCode.end();)
+        it = m_usedCompositeCode.count(it->first) > 0 ? std::next(it) : m_compositeCode.erase(it);
+    m_usedCompositeCode.clear();
     QString data = constants::kedro::PIPELINE_PY.arg(serializedObjects.join(",\n"));
     QFile pipelinePy(source.absoluteFilePath("pipeline.py"));
     if (!pipelinePy.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qCritical() << "Cannot open pipeline.py:" << pipelinePy.errorString();
+        qCCritical(lcEngine) << "Cannot open pipeline.py:" << pipelinePy.errorString();
         return false;
     }
     QTextStream out(&pipelinePy);
@@ -392,7 +599,7 @@ QDir Kedro::ensureDirExists(const QString &path)
 
     QDir dir(path);
     if (!dir.exists() && !dir.mkpath(".")) {
-        qCritical() << "Failed to create directory:" << dir.absolutePath();
+        qCCritical(lcEngine) << "Failed to create directory:" << dir.absolutePath();
     }
     return dir;
 }
@@ -427,7 +634,7 @@ void Kedro::postScoreModel(CustomGraph *graph, const QtNodes::NodeId &id)
         // XXX HACKY PARSER
         QFile yml(reportDir.absoluteFilePath("score.yml"));
         if (!yml.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            qWarning() << "Cannot open score.yml";
+            qCWarning(lcEngine) << "Cannot open score.yml";
             return;
         }
         // this signal is used in unit tests
@@ -5,19 +5,30 @@
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTextStream>
+#include <QTimer>
 
+#include <chrono>
 #include <iostream>
 
 #include <QtUtility/file/file.hpp>
 
+#include "data/settings.hpp"
+#include "logging_categories.hpp"
+
 namespace {
 
-std::map<QtMsgType, QColor> TYPE_COLOR = {
-    {QtWarningMsg, Qt::yellow},
-    {QtCriticalMsg, Qt::red},
-    {QtFatalMsg, Qt::red},
-};
+// messages that can wait for the logger thread, producers never block on a full queue
+constexpr size_t QUEUE_CAPACITY = 1 << 14;
+// how long the logger thread sleeps between batches
+constexpr std::chrono::milliseconds WRITE_INTERVAL(20);
+// panels are refreshed at this rate however many messages arrive
+constexpr int PANEL_INTERVAL_MS = 100;
+// messages kept for the panels while the gui thread is busy
+constexpr size_t MAX_PENDING = 10000;
+
 std::map<QtMsgType, QString> TYPE_STRING = {
     {QtDebugMsg, "debug"},
     {QtInfoMsg, "info"},
@@ -50,43 +61,41 @@ QFileInfo getLogFile()
     return fileInfo;
 }
 
-void logHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+LogRecord internalRecord(const QString &message)
 {
-    static QFile logFile(getLogFile().absoluteFilePath());
-    if (!logFile.isOpen()) {
-        logFile.open(QIODevice::Append | QIODevice::Text);
-    }
-    QTextStream out(&logFile);
-
-    // use qSetMessagePattern to format
-    auto message = qFormatLogMessage(type, context, msg);
-
-    out << message << "\n";
-    std::cerr << message.toStdString() << std::endl;
-
-    emit LogManager::instance().callAppendMessage(message, type);
-
-    out.flush();
+    return {{message, QtWarningMsg, "descartes.log"},
+            message,
+            QDateTime::currentMSecsSinceEpoch()};
+}
 
-    if (type == QtFatalMsg)
+void logHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    if (type == QtFatalMsg) {
+        LogManager::instance().writeFatal(context, msg);
         abort();
+    }
+    LogManager::instance().enqueue(type, context, msg);
 }
 
 } // namespace
 
+LogManager::LogManager()
+    : m_queue(QUEUE_CAPACITY)
+{}
+
 LogManager::~LogManager()
 {
     qInstallMessageHandler(m_originalHandler);
+    shutdown();
 }
 
 void LogManager::init()
 {
-    // this must be queued connection to trigger appendMessage on a GUI thread
-    connect(this,
-            &LogManager::callAppendMessage,
-            this,
-            &LogManager::appendMessage,
-            Qt::QueuedConnection);
+    // the panels are only touched from the gui thread, at a fixed rate
+    m_panelTimer = new QTimer(this);
+    m_panelTimer->setInterval(PANEL_INTERVAL_MS);
+    connect(m_panelTimer, &QTimer::timeout, this, &LogManager::deliverPending);
+    m_panelTimer->start();
 #ifdef QT_DEBUG
     qSetMessagePattern(
         "[%{time yyyy-MM-dd HH:mm:ss.zzz}] "
@@ -98,16 +107,175 @@ void LogManager::init()
         "[%{if-debug}debug%{endif}%{if-info}info%{endif}%{if-warning}warning%{endif}%{if-critical}"
         "error%{endif}%{if-fatal}fatal%{endif}]: %{message}");
 #endif
+    auto logFile = getLogFile();
+    m_logFilePath = logFile.absoluteFilePath();
+    m_jsonFilePath = logFile.dir().absoluteFilePath(logFile.completeBaseName() + ".jsonl");
+
+    auto &settings = data::Settings::instance();
+    logging::setDebugSubsystems(settings.value("debug log subsystems").toStringList());
+    connect(&settings,
+            &data::Settings::settingUpdated,
+            this,
+            [](const QString &key, const QVariant &value) {
+                if (key == "debug log subsystems")
+                    logging::setDebugSubsystems(value.toStringList());
+            });
+
+    m_running = true;
+    m_thread = std::thread(&LogManager::run, this);
     m_originalHandler = qInstallMessageHandler(logHandler);
 }
 
+LogRecord LogManager::makeRecord(QtMsgType type,
+                                 const QMessageLogContext &context,
+                                 const QString &message)
+{
+    // the context is only valid during the call, formatting is done here. File and function
+    // point to string literals and outlive it
+    return {{qFormatLogMessage(type, context, message),
+             type,
+             QString::fromLatin1(context.category)},
+            message,
+            QDateTime::currentMSecsSinceEpoch(),
+            context.file,
+            context.function,
+            context.line};
+}
+
+void LogManager::enqueue(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    if (!m_queue.tryPush(makeRecord(type, context, message)))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogManager::writeFatal(const QMessageLogContext &context, const QString &message)
+{
+    // the messages before it are written first, the fatal one can't be lost to a full queue
+    shutdown();
+    std::vector<LogRecord> batch{makeRecord(QtFatalMsg, context, message)};
+    QFile logFile(m_logFilePath);
+    QFile jsonFile(m_jsonFilePath);
+    if (!m_logFilePath.isEmpty()) {
+        logFile.open(QIODevice::Append | QIODevice::Text);
+        jsonFile.open(QIODevice::Append);
+    }
+    write(batch, logFile, jsonFile);
+}
+
+void LogManager::shutdown()
+{
+    if (!m_running.exchange(false))
+        return;
+    m_wake.notify_one();
+    if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+        m_thread.join();
+}
+
+void LogManager::run()
+{
+    QFile logFile(m_logFilePath);
+    logFile.open(QIODevice::Append | QIODevice::Text);
+    QFile jsonFile(m_jsonFilePath);
+    jsonFile.open(QIODevice::Append);
+    std::vector<LogRecord> batch;
+    quint64 reportedDrops = 0;
+    for (;;) {
+        // read before draining so the last batch is written after a shutdown
+        bool running = m_running.load();
+        LogRecord record;
+        while (m_queue.tryPop(record))
+            batch.push_back(std::move(record));
+        auto dropped = droppedCount();
+        if (dropped > reportedDrops) {
+            batch.push_back(internalRecord(
+                QString("%1 log messages were dropped, the queue was full.")
+                    .arg(dropped - reportedDrops)));
+            reportedDrops = dropped;
+        }
+        if (!batch.empty()) {
+            write(batch, logFile, jsonFile);
+            queueForPanels(batch);
+        }
+        if (!running)
+            break;
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, WRITE_INTERVAL, [this]() { return !m_running.load(); });
+    }
+}
+
+void LogManager::write(const std::vector<LogRecord> &batch, QFile &logFile, QFile &jsonFile)
+{
+    QTextStream out(&logFile);
+    QByteArray json;
+    std::string console;
+    for (const auto &entry : batch) {
+        out << entry.line.text << "\n";
+        json += toJsonLine(entry);
+        console += entry.line.text.toStdString() + '\n';
+    }
+    // files that failed to open are skipped, the console still gets the messages
+    if (logFile.isOpen())
+        out.flush();
+    if (jsonFile.isOpen()) {
+        jsonFile.write(json);
+        jsonFile.flush();
+    }
+    // one write and flush per batch rather than per message
+    std::cerr << console << std::flush;
+}
+
+QByteArray LogManager::toJsonLine(const LogRecord &record)
+{
+    QJsonObject object{
+        {"time", QDateTime::fromMSecsSinceEpoch(record.time).toString(Qt::ISODateWithMs)},
+        {"level", TYPE_STRING.at(record.line.type)},
+        {"category", record.line.category},
+        {"message", record.message},
+    };
+    if (record.file) {
+        object.insert("file", QString::fromUtf8(record.file));
+        object.insert("line", record.lineNumber);
+    }
+    if (record.function)
+        object.insert("function", QString::fromUtf8(record.function));
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+void LogManager::queueForPanels(std::vector<LogRecord> &batch)
+{
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    for (auto &record : batch)
+        m_pending.push_back(std::move(record.line));
+    batch.clear();
+    if (m_pending.size() > MAX_PENDING) {
+        auto excess = m_pending.size() - MAX_PENDING;
+        m_pending.erase(m_pending.begin(), m_pending.begin() + excess);
+        m_pendingDropped += excess;
+    }
+}
+
+void LogManager::deliverPending()
+{
+    std::vector<LogLine> lines;
+    quint64 dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        lines.swap(m_pending);
+        std::swap(dropped, m_pendingDropped);
+    }
+    if (dropped > 0) {
+        auto message = QString("%1 older log messages are only in the log file.").arg(dropped);
+        lines.insert(lines.begin(), LogLine{message, QtWarningMsg, "descartes.log"});
+    }
+    appendMessages(lines);
+}
+
 void LogManager::registerLogPanel(LogPanel *panel)
 {
     if (!m_logPanels.contains(panel)) {
         m_logPanels.push_back(panel);
         if (!m_notPrinted.empty()) {
-            for (auto message : m_notPrinted)
-                panel->appendMessage(message.string, message.color);
+            panel->appendMessages(m_notPrinted);
             m_notPrinted.clear();
         }
     }
@@ -115,12 +283,16 @@ void LogManager::registerLogPanel(LogPanel *panel)
 
 void LogManager::appendMessage(const QString &message, const QtMsgType &type)
 {
-    QColor color;
-    if (TYPE_COLOR.count(type) > 0)
-        color = TYPE_COLOR[type];
+    appendMessages({{message, type, "default"}});
+}
+
+void LogManager::appendMessages(const std::vector<LogLine> &lines)
+{
+    if (lines.empty())
+        return;
     for (LogPanel *panel : m_logPanels)
         if (panel)
-            panel->appendMessage(message, color);
+            panel->appendMessages(lines);
     if (m_logPanels.isEmpty())
-        m_notPrinted.push_back({message, color});
+        m_notPrinted.insert(m_notPrinted.end(), lines.begin(), lines.end());
 }
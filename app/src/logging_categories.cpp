@@ -0,0 +1,28 @@
+#include "logging_categories.hpp"
+
+// debug is disabled by default, a disabled qCDebug costs one check and no formatting
+Q_LOGGING_CATEGORY(lcEngine, "descartes.engine", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcGraph, "descartes.graph", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcTyping, "descartes.typing", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcIo, "descartes.io", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcUi, "descartes.ui", QtInfoMsg)
+
+namespace logging {
+
+const QStringList &subsystems()
+{
+    static const QStringList NAMES = {"engine", "graph", "typing", "io", "ui"};
+    return NAMES;
+}
+
+void setDebugSubsystems(const QStringList &enabled)
+{
+    QStringList rules;
+    for (const auto &name : subsystems()) {
+        auto value = enabled.contains(name) ? "true" : "false";
+        rules << QString("descartes.%1.debug=%2").arg(name, value);
+    }
+    QLoggingCategory::setFilterRules(rules.join('\n'));
+}
+
+} // namespace logging
@@ -0,0 +1,86 @@
+#include "ui/lod_node_painter.hpp"
+
+#include <QJsonDocument>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include <QtNodes/AbstractGraphModel>
+#include <QtNodes/AbstractNodeGeometry>
+#include <QtNodes/BasicGraphicsScene>
+#include <QtNodes/DirectedAcyclicGraphModel>
+#include <QtNodes/NodeGraphicsObject>
+#include <QtNodes/StyleCollection>
+
+#include "ui/models/fdf_block_model.hpp"
+
+using QtNodes::NodeGraphicsObject;
+using QtNodes::NodeRole;
+using QtNodes::NodeStyle;
+
+LodNodePainter::Detail LodNodePainter::detail(double levelOfDetail)
+{
+    if (levelOfDetail >= FULL_DETAIL)
+        return Detail::Full;
+    return levelOfDetail >= CAPTION_DETAIL ? Detail::Caption : Detail::Box;
+}
+
+bool LodNodePainter::cacheConnection(const QRectF &bounds, double scale)
+{
+    return bounds.width() * bounds.height() * scale * scale <= MAX_CACHED_CONNECTION_AREA;
+}
+
+void LodNodePainter::paint(QPainter *painter, NodeGraphicsObject &ngo) const
+{
+    const auto level = detail(
+        QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()));
+    if (level != Detail::Full)
+        return paintSimplified(painter, ngo, level == Detail::Caption);
+    DefaultNodePainter::paint(painter, ngo);
+    paintContent(painter, ngo);
+}
+
+void LodNodePainter::paintContent(QPainter *painter, NodeGraphicsObject &ngo) const
+{
+    auto graph = dynamic_cast<QtNodes::DirectedAcyclicGraphModel *>(&ngo.graphModel());
+    if (!graph)
+        return;
+    auto block = graph->delegateModel<FdfBlockModel>(ngo.nodeId());
+    if (!block || block->contentSize().isEmpty())
+        return;
+    const QSize size = ngo.nodeScene()->nodeGeometry().size(ngo.nodeId());
+    painter->save();
+    block->paintContent(painter, block->contentRect(size));
+    painter->restore();
+}
+
+void LodNodePainter::paintSimplified(QPainter *painter,
+                                     NodeGraphicsObject &ngo,
+                                     bool withCaption) const
+{
+    auto &model = ngo.graphModel();
+    const auto nodeId = ngo.nodeId();
+    const QSize size = ngo.nodeScene()->nodeGeometry().size(nodeId);
+    const QRectF boundary(QPointF(0, 0), size);
+
+    QJsonDocument json = QJsonDocument::fromVariant(model.nodeData(nodeId, NodeRole::Style));
+    NodeStyle style(json.object());
+    // no gradient, antialiasing or ports, the box is a handful of device pixels at this scale
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setPen(QPen(ngo.isSelected() ? style.SelectedBoundaryColor
+                                          : style.NormalBoundaryColor,
+                         style.PenWidth));
+    painter->setBrush(style.GradientColor1);
+    painter->drawRect(boundary);
+
+    if (!withCaption)
+        return;
+    QFont font = painter->font();
+    font.setBold(true);
+    // doubled to stay readable at the reduced scale
+    font.setPointSizeF(font.pointSizeF() * 2);
+    painter->setFont(font);
+    painter->setPen(style.FontColor);
+    painter->drawText(boundary,
+                      Qt::AlignCenter | Qt::TextWordWrap,
+                      model.nodeData(nodeId, NodeRole::Caption).toString());
+}
@@ -0,0 +1,128 @@
+#include "ui/log_line_store.hpp"
+
+#include <QDataStream>
+#include <QDebug>
+
+#include "logging_categories.hpp"
+
+namespace {
+quint64 trigramHash(const QChar *chars)
+{
+    quint64 key = quint64(chars[0].unicode()) << 32 | quint64(chars[1].unicode()) << 16
+                  | chars[2].unicode();
+    // mixes the key so both halves are usable as independent hashes
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    return key ^ (key >> 33);
+}
+
+// bit of the i-th hash, derived from the two halves of the trigram hash
+size_t bloomBit(quint64 hash, size_t i, size_t bits)
+{
+    quint64 first = hash & 0xffffffff;
+    quint64 second = (hash >> 32) | 1;
+    return (first + i * second) % bits;
+}
+} // namespace
+
+void LogLineStore::append(const LogLine &line)
+{
+    if (m_types.size() % CHUNK_LINES == 0) {
+        // the previous chunk is full and becomes a spill candidate
+        if (!m_chunks.empty())
+            touch(m_chunks.size() - 1);
+        m_chunks.emplace_back();
+        m_chunks.back().lines.reserve(CHUNK_LINES);
+    }
+    auto &chunk = m_chunks.back();
+    chunk.lines.push_back(line.text);
+    addTrigrams(chunk.trigrams, line.text.toLower());
+    m_types.push_back(static_cast<quint8>(line.type));
+
+    int category = m_categoryNames.indexOf(line.category);
+    if (category < 0) {
+        category = m_categoryNames.size();
+        m_categoryNames.append(line.category);
+    }
+    m_categories.push_back(static_cast<quint16>(category));
+}
+
+QString LogLineStore::text(size_t line) const
+{
+    size_t chunk = line / CHUNK_LINES;
+    if (chunk + 1 < m_chunks.size())
+        touch(chunk);
+    const auto &lines = m_chunks.at(chunk).lines;
+    size_t index = line % CHUNK_LINES;
+    return index < lines.size() ? lines.at(index) : QString();
+}
+
+void LogLineStore::addTrigrams(Bloom &bloom, const QString &text)
+{
+    for (qsizetype i = 0; i + 2 < text.size(); ++i) {
+        auto hash = trigramHash(text.constData() + i);
+        for (size_t k = 0; k < BLOOM_HASHES; ++k)
+            bloom.set(bloomBit(hash, k, BLOOM_BITS));
+    }
+}
+
+bool LogLineStore::mayContain(size_t chunk, const QString &query) const
+{
+    // shorter queries have no trigram to look up
+    const auto &bloom = m_chunks.at(chunk).trigrams;
+    for (qsizetype i = 0; i + 2 < query.size(); ++i) {
+        auto hash = trigramHash(query.constData() + i);
+        for (size_t k = 0; k < BLOOM_HASHES; ++k)
+            if (!bloom.test(bloomBit(hash, k, BLOOM_BITS)))
+                return false;
+    }
+    return true;
+}
+
+void LogLineStore::touch(size_t chunk) const
+{
+    auto found = std::find(m_resident.begin(), m_resident.end(), chunk);
+    if (found != m_resident.end()) {
+        m_resident.splice(m_resident.begin(), m_resident, found);
+        return;
+    }
+    load(chunk);
+    m_resident.push_front(chunk);
+    if (m_resident.size() > RESIDENT_CHUNKS) {
+        spill(m_resident.back());
+        m_resident.pop_back();
+    }
+}
+
+void LogLineStore::spill(size_t chunk) const
+{
+    auto &target = m_chunks.at(chunk);
+    // chunks are full when spilled and never change, one write is enough
+    if (target.fileOffset < 0) {
+        if (!m_spillFile.isOpen() && !m_spillFile.open()) {
+            qCCritical(lcUi) << "Cannot open the log spill file, keeping the lines in memory";
+            return;
+        }
+        target.fileOffset = m_spillFile.size();
+        m_spillFile.seek(target.fileOffset);
+        QDataStream out(&m_spillFile);
+        out << QStringList(target.lines.begin(), target.lines.end());
+        m_spillFile.flush();
+    }
+    std::vector<QString>().swap(target.lines);
+}
+
+void LogLineStore::load(size_t chunk) const
+{
+    auto &target = m_chunks.at(chunk);
+    if (!target.lines.empty() || target.fileOffset < 0)
+        return;
+    ++m_loads;
+    m_spillFile.seek(target.fileOffset);
+    QDataStream in(&m_spillFile);
+    QStringList lines;
+    in >> lines;
+    target.lines.assign(lines.begin(), lines.end());
+}
@@ -1,26 +1,239 @@
 #include "ui/log_panel.hpp"
 
-#include <QApplication>
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QListView>
+#include <QScrollBar>
+#include <QTimer>
+#include <QVBoxLayout>
 
 #include "log_manager.hpp"
 
+namespace {
+
+// pause in typing before searching, a query is not searched for every keystroke
+constexpr int SEARCH_DELAY_MS = 250;
+
+std::map<QtMsgType, QColor> TYPE_COLOR = {
+    {QtWarningMsg, Qt::yellow},
+    {QtCriticalMsg, Qt::red},
+    {QtFatalMsg, Qt::red},
+};
+
+// QtMsgType values are not ordered by severity
+int severity(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return 0;
+    case QtInfoMsg:
+        return 1;
+    case QtWarningMsg:
+        return 2;
+    case QtCriticalMsg:
+        return 3;
+    case QtFatalMsg:
+        return 4;
+    }
+    return 0;
+}
+
+const std::vector<std::pair<QString, QtMsgType>> LEVELS = {
+    {"All levels", QtDebugMsg},
+    {"Info and above", QtInfoMsg},
+    {"Warnings and above", QtWarningMsg},
+    {"Errors", QtCriticalMsg},
+};
+
+} // namespace
+
+LogListModel::LogListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{}
+
+int LogListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_filtered ? m_rows.size() : m_store.size();
+}
+
+QVariant LogListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+    auto line = lineAt(index.row());
+    if (role == Qt::DisplayRole)
+        return m_store.text(line);
+    if (role == Qt::ForegroundRole) {
+        auto color = TYPE_COLOR.find(m_store.type(line));
+        if (color != TYPE_COLOR.end())
+            return color->second;
+    }
+    return QVariant();
+}
+
+void LogListModel::append(const std::vector<LogLine> &lines)
+{
+    if (lines.empty())
+        return;
+    auto categories = m_store.categories().size();
+    // rows are counted before the store grows, views must not see the new lines before
+    // beginInsertRows
+    const int row = rowCount();
+    std::vector<size_t> visible;
+    for (size_t i = 0; i < lines.size(); ++i)
+        if (!m_filtered || accepts(lines.at(i)))
+            visible.push_back(m_store.size() + i);
+    if (!visible.empty())
+        beginInsertRows(QModelIndex(), row, row + visible.size() - 1);
+    for (const auto &line : lines)
+        m_store.append(line);
+    if (m_filtered)
+        m_rows.insert(m_rows.end(), visible.begin(), visible.end());
+    if (!visible.empty())
+        endInsertRows();
+    for (auto i = categories; i < m_store.categories().size(); ++i)
+        emit categoryAdded(m_store.categories().at(i));
+}
+
+void LogListModel::setMinimumLevel(QtMsgType level)
+{
+    m_minimumSeverity = severity(level);
+    refilter();
+}
+
+void LogListModel::setCategory(const QString &category)
+{
+    m_category = category.isEmpty() ? -1 : m_store.categories().indexOf(category);
+    refilter();
+}
+
+bool LogListModel::accepts(size_t line) const
+{
+    if (severity(m_store.type(line)) < m_minimumSeverity)
+        return false;
+    return m_category < 0 || m_store.category(line) == m_category;
+}
+
+bool LogListModel::accepts(const LogLine &line) const
+{
+    if (severity(line.type) < m_minimumSeverity)
+        return false;
+    return m_category < 0 || line.category == m_store.categories().at(m_category);
+}
+
+size_t LogListModel::lineAt(int row) const
+{
+    return m_filtered ? m_rows.at(row) : row;
+}
+
+int LogListModel::rowOf(size_t line) const
+{
+    if (!m_filtered)
+        return line;
+    return std::lower_bound(m_rows.begin(), m_rows.end(), line) - m_rows.begin();
+}
+
+void LogListModel::refilter()
+{
+    // levels and categories are held in memory, no line text is read
+    beginResetModel();
+    m_filtered = m_minimumSeverity > 0 || m_category >= 0;
+    m_rows.clear();
+    if (m_filtered)
+        for (size_t line = 0; line < m_store.size(); ++line)
+            if (accepts(line))
+                m_rows.push_back(line);
+    endResetModel();
+}
+
 LogPanel::LogPanel(QWidget *parent)
-    : QPlainTextEdit(parent)
-    , m_DEFAULT_TEXT_COLOR(QApplication::palette().text().color())
+    : QWidget(parent)
+    , m_model(new LogListModel(this))
+    , m_view(new QListView)
+    , m_levelBox(new QComboBox)
+    , m_categoryBox(new QComboBox)
+    , m_searchEdit(new QLineEdit)
+    , m_searchTimer(new QTimer(this))
 {
-    setReadOnly(true);
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    {
+        auto filters = new QHBoxLayout;
+        for (const auto &level : LEVELS)
+            m_levelBox->addItem(level.first);
+        m_categoryBox->addItem("All categories");
+        m_searchEdit->setPlaceholderText("Search, enter for next match");
+        m_searchEdit->setClearButtonEnabled(true);
+        filters->addWidget(m_levelBox);
+        filters->addWidget(m_categoryBox);
+        filters->addWidget(m_searchEdit, 1);
+        layout->addLayout(filters);
+    }
+    // rows share one height, so the view never measures the lines it does not show
+    m_view->setModel(m_model);
+    m_view->setUniformItemSizes(true);
+    m_view->setFont(QFont("Courier", 12));
+    m_view->setWordWrap(false);
+    m_view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_view->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    layout->addWidget(m_view);
+
+    connect(m_levelBox, &QComboBox::currentIndexChanged, m_model, [this](int index) {
+        m_model->setMinimumLevel(LEVELS.at(index).second);
+    });
+    connect(m_categoryBox, &QComboBox::currentIndexChanged, m_model, [this](int index) {
+        m_model->setCategory(index > 0 ? m_categoryBox->itemText(index) : QString());
+    });
+    connect(m_model, &LogListModel::categoryAdded, m_categoryBox, [this](const QString &category) {
+        m_categoryBox->addItem(category);
+    });
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, &LogPanel::findNext);
+    // search as you type, the current match is kept while it still matches
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(SEARCH_DELAY_MS);
+    connect(m_searchEdit, &QLineEdit::textEdited, m_searchTimer, qOverload<>(&QTimer::start));
+    connect(m_searchTimer, &QTimer::timeout, this, [this]() {
+        auto current = m_view->currentIndex();
+        find(current.isValid() ? m_model->lineAt(current.row()) : 0);
+    });
     LogManager::instance().registerLogPanel(this);
 }
 
-void LogPanel::appendMessage(const QString &text, const QColor &color)
+void LogPanel::appendMessage(const QString &text, QtMsgType type)
+{
+    appendMessages({{text, type, "default"}});
+}
+
+void LogPanel::appendMessages(const std::vector<LogLine> &lines)
+{
+    auto scrollBar = m_view->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+    m_model->append(lines);
+    if (atBottom)
+        m_view->scrollToBottom();
+}
+
+void LogPanel::findNext()
+{
+    m_searchTimer->stop();
+    auto current = m_view->currentIndex();
+    find(current.isValid() ? m_model->lineAt(current.row()) + 1 : 0);
+}
+
+void LogPanel::find(size_t from)
 {
-    QTextCharFormat format = currentCharFormat();
-    format.setForeground(QBrush(color.isValid() ? color : m_DEFAULT_TEXT_COLOR));
-    auto cursor = textCursor();
-    cursor.clearSelection();
-    setTextCursor(cursor);
-    setCurrentCharFormat(format);
-    appendPlainText(text);
-    setFont(QFont("Courier", 12));
-    setLineWrapMode(QPlainTextEdit::NoWrap);
-}
\ No newline at end of file
+    auto query = m_searchEdit->text();
+    auto accept = [this](size_t line) { return m_model->accepts(line); };
+    auto found = m_model->store().find(query, from, accept);
+    // wrap around once
+    if (found == LogLineStore::NOT_FOUND && from > 0)
+        found = m_model->store().find(query, 0, accept);
+    if (found == LogLineStore::NOT_FOUND)
+        return;
+    auto index = m_model->index(m_model->rowOf(found));
+    m_view->setCurrentIndex(index);
+    m_view->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
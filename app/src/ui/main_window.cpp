@@ -29,6 +29,7 @@ using QtNodes::NodeStyle;
 #include "data/tab_components.hpp"
 #include "data/tab_manager.hpp"
 #include "engine/engine_starter.hpp"
+#include "logging_categories.hpp"
 #include "temp.hpp"
 #include "ui/bottom_panel.hpp"
 #include "ui/graphics_scene_tab_widget.hpp"
@@ -59,7 +60,7 @@ MainWindow::MainWindow()
         setGeometry(QApplication::primaryScreen()->availableGeometry());
         showMaximized();
     }
-    qInfo() << "Welcome to DesCartes Builder";
+    qCInfo(lcUi) << "Welcome to DesCartes Builder";
 }
 
 MainWindow::~MainWindow()
@@ -70,7 +71,7 @@ MainWindow::~MainWindow()
                this,
                &MainWindow::onBlockSelected);
     m_tabManager->clear();
-    qInfo() << "Program has finished.";
+    qCInfo(lcUi) << "Program has finished.";
 }
 
 bool MainWindow::openDCB(const QString &filePath)
@@ -87,7 +88,7 @@ bool MainWindow::callExecute()
 {
     auto currentTab = m_tabManager->getCurrentTab();
     if (!currentTab) {
-        qWarning() << "No tab to execute";
+        qCWarning(lcUi) << "No tab to execute";
         return false;
     }
     if (!validateTab(currentTab)) {
@@ -99,13 +100,13 @@ bool MainWindow::callExecute()
 bool MainWindow::validateTab(std::shared_ptr<TabComponents> &tab)
 {
     if (!tab) {
-        qWarning() << "No tab to verify";
+        qCWarning(lcUi) << "No tab to verify";
         return false;
     }
     // Save silently if tab has a file associated with already
     if (!tab->isNewFile()) {
         if (!m_tabManager->save()) {
-            qWarning() << "Save failed";
+            qCWarning(lcUi) << "Save failed";
             return false;
         }
     } else {
@@ -202,6 +203,9 @@ void MainWindow::initMenuBar()
     nextTabAction->setDisabled(true);
     previousTabAction->setDisabled(true);
     fileMenu->addSeparator();
+    auto groupAction = fileMenu->addAction("Group into composite");
+    auto editCompositeAction = fileMenu->addAction("Edit composite");
+    auto layoutAction = fileMenu->addAction("Auto layout");
     auto runAction = fileMenu->addAction("Run");
 
     newAction->setShortcuts({QKeySequence::New, QKeySequence::AddTab});
@@ -212,6 +216,9 @@ void MainWindow::initMenuBar()
     nextTabAction->setShortcut(QKeyCombination(Qt::MetaModifier, Qt::Key_Tab));
     previousTabAction->setShortcut(
         QKeyCombination(Qt::MetaModifier | Qt::ShiftModifier, Qt::Key_Tab));
+    groupAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_G));
+    editCompositeAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_E));
+    layoutAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_L));
     runAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_R));
 
     connect(newAction, &QAction::triggered, m_tabManager.get(), &TabManager::newTab);
@@ -239,6 +246,18 @@ void MainWindow::initMenuBar()
                 nextTabAction->setEnabled(MORE_THAN_ONE);
                 previousTabAction->setEnabled(MORE_THAN_ONE);
             });
+    connect(groupAction,
+            &QAction::triggered,
+            m_blockManager.get(),
+            &BlockManager::groupSelectedBlocks);
+    connect(editCompositeAction,
+            &QAction::triggered,
+            m_blockManager.get(),
+            &BlockManager::editSelectedComposite);
+    connect(layoutAction,
+            &QAction::triggered,
+            m_blockManager.get(),
+            &BlockManager::layoutCurrentGraph);
     connect(runAction, &QAction::triggered, this, &MainWindow::callExecute);
 
 #ifdef DEBUG
@@ -14,18 +14,19 @@ std::unordered_map<Process, QString> TRANSFORM_STRING = {
     {Process::None, "none"},
     {Process::Std, "std"},
 };
+constexpr ParameterDescriptor CODER_PARAMETERS[] = {
+    {&CoderModel::PROCESS, QMetaType::QString},
+    {&CoderModel::RANDOM_STATE, QMetaType::Int},
+};
 } // namespace
 
 CoderModel::CoderModel(const QString &name, const QString &functionName)
     : FdfBlockModel(FdfType::Coder, name, functionName)
 {}
 
-std::unordered_map<QString, QMetaType::Type> CoderModel::getParameterSchema() const
+ParameterSchema CoderModel::getParameterSchema() const
 {
-    std::unordered_map<QString, QMetaType::Type> schema;
-    schema[PROCESS] = QMetaType::QString;
-    schema[RANDOM_STATE] = QMetaType::Int;
-    return schema;
+    return CODER_PARAMETERS;
 }
 
 bool CoderModel::portNumberModifiable(const PortType &portType) const
@@ -33,13 +34,13 @@ bool CoderModel::portNumberModifiable(const PortType &portType) const
     return portType == PortType::In;
 }
 
-uint CoderModel::minModifiablePorts(const PortType &portType, const QString &typeId) const
+uint CoderModel::minModifiablePorts(const PortType &portType, PortKind kind) const
 {
     if (portType == PortType::In)
-        if (typeId == constants::DATA_PORT_ID)
+        if (kind == DataPort)
             return 1;
     if (portType == PortType::Out)
-        if (typeId == constants::FUNCTION_PORT_ID)
+        if (kind == FunctionPort)
             return 1;
     return 0;
 }
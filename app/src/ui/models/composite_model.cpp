@@ -0,0 +1,245 @@
+#include "ui/models/composite_model.hpp"
+
+#include "data/block_manager.hpp"
+#include "data/custom_graph.hpp"
+#include "data/graph_snapshot.hpp"
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace {
+const QString PIPELINE = "pipeline";
+
+// boundary blocks as found in a saved graph, sorted by id like in a built graph
+std::vector<std::pair<QtNodes::NodeId, QString>> savedBoundaryNodes(const QJsonObject &pipeline,
+                                                                    const QString &name)
+{
+    std::vector<std::pair<QtNodes::NodeId, QString>> result;
+    for (const auto &value : pipeline["nodes"].toArray()) {
+        auto node = value.toObject();
+        auto model = node["internal-data"].toObject();
+        if (model["name"].toString() == name)
+            result.emplace_back(node["id"].toInt(), model["caption"].toString());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+} // namespace
+
+CompositeInputModel::CompositeInputModel()
+    : FdfBlockModel(FdfType::Data, composite_names::INPUT)
+{
+    addPort<DataNode>(PortType::Out, "input");
+}
+
+CompositeOutputModel::CompositeOutputModel()
+    : FdfBlockModel(FdfType::Output, composite_names::OUTPUT)
+{
+    addPort<DataNode>(PortType::In);
+}
+
+CompositeModel::CompositeModel()
+    : FdfBlockModel(FdfType::Processor, composite_names::COMPOSITE)
+{}
+
+CompositeModel::~CompositeModel()
+{
+    if (m_subGraph)
+        m_subGraph->disconnect(this);
+}
+
+QJsonObject CompositeModel::save() const
+{
+    QJsonObject modelJson = FdfBlockModel::save();
+    modelJson[PIPELINE] = pipeline();
+    return modelJson;
+}
+
+void CompositeModel::load(QJsonObject const &p)
+{
+    // ports have to exist before the base class restores their tags
+    if (p.contains(PIPELINE))
+        setPipeline(p[PIPELINE].toObject());
+    FdfBlockModel::load(p);
+}
+
+QStringList CompositeModel::validityIssues() const
+{
+    auto issues = FdfBlockModel::validityIssues();
+    if (boundaryNodes(composite_names::OUTPUT).empty())
+        issues << QString("The sub-pipeline of block %1 has no outputs.").arg(caption());
+    if (m_subGraph && !m_subGraph->allBlocksValid())
+        issues << QString("Some blocks in the sub-pipeline of block %1 are not valid.")
+                      .arg(caption());
+    return issues;
+}
+
+QJsonObject CompositeModel::pipeline() const
+{
+    return m_subGraph ? m_subGraph->save() : m_pipeline;
+}
+
+void CompositeModel::setPipeline(const QJsonObject &pipeline)
+{
+    if (m_subGraph)
+        m_subGraph->disconnect(this);
+    m_subGraph.reset();
+    m_pipeline = pipeline;
+    m_fingerprint.clear();
+    updatePorts();
+    emit contentUpdated();
+}
+
+void CompositeModel::setSubGraph(std::unique_ptr<CustomGraph> graph)
+{
+    m_subGraph = std::move(graph);
+    m_pipeline = QJsonObject();
+    m_fingerprint.clear();
+    connectSubGraph();
+    updatePorts();
+    updateOutputTypes();
+    emit contentUpdated();
+}
+
+CustomGraph *CompositeModel::expand()
+{
+    if (m_subGraph)
+        return m_subGraph.get();
+    m_subGraph = makeSubGraph(true);
+    {
+        CustomGraph::Batch batch(*m_subGraph);
+        m_subGraph->load(m_pipeline);
+    }
+    m_pipeline = QJsonObject();
+    connectSubGraph();
+    for (PortIndex i = 0; i < nPorts(PortType::In); ++i)
+        onDataInputSet(i);
+    return m_subGraph.get();
+}
+
+void CompositeModel::collapse()
+{
+    if (!m_subGraph)
+        return;
+    m_pipeline = m_subGraph->save();
+    m_subGraph->disconnect(this);
+    m_subGraph.reset();
+}
+
+QString CompositeModel::fingerprint() const
+{
+    // the built graph can change under us, the saved one only through setPipeline
+    if (!m_subGraph && !m_fingerprint.isEmpty())
+        return m_fingerprint;
+    auto json = QJsonDocument(pipeline()).toJson(QJsonDocument::Compact);
+    auto hash = QString::fromLatin1(
+        QCryptographicHash::hash(json, QCryptographicHash::Sha1).toHex());
+    if (!m_subGraph)
+        m_fingerprint = hash;
+    return hash;
+}
+
+std::shared_ptr<const GraphSnapshot> CompositeModel::pipelineSnapshot() const
+{
+    if (m_subGraph)
+        return m_subGraph->snapshot();
+    auto current = fingerprint();
+    if (m_snapshot && m_snapshotFingerprint == current)
+        return m_snapshot;
+    // built only long enough to be copied, the block stays collapsed
+    auto graph = makeSubGraph(false);
+    {
+        CustomGraph::Batch batch(*graph);
+        graph->load(m_pipeline);
+    }
+    m_snapshot = graph->snapshot();
+    m_snapshotFingerprint = current;
+    return m_snapshot;
+}
+
+void CompositeModel::onDataInputSet(const PortIndex &index)
+{
+    if (!m_subGraph)
+        return;
+    auto inputs = boundaryNodes(composite_names::INPUT);
+    if (index >= inputs.size())
+        return;
+    auto input = m_subGraph->delegateModel<FdfBlockModel>(inputs.at(index).first);
+    auto data = castedPort<DataNode>(PortType::In, index);
+    if (auto port = input->outPort<DataNode>(0)) {
+        port->setTypeId(data ? data->typeId() : UIDManager::NONE_ID);
+        input->propagateUpdate();
+    }
+    updateOutputTypes();
+}
+
+void CompositeModel::connectSubGraph()
+{
+    // edits inside change the ports and the generated code of the block
+    auto onChanged = [this]() {
+        if (m_subGraph->inBatch())
+            return;
+        updatePorts();
+        updateOutputTypes();
+        emit contentUpdated();
+    };
+    connect(m_subGraph.get(), &CustomGraph::nodeCreated, this, onChanged);
+    connect(m_subGraph.get(), &CustomGraph::nodeDeleted, this, onChanged);
+    connect(m_subGraph.get(), &CustomGraph::connectionCreated, this, onChanged);
+    connect(m_subGraph.get(), &CustomGraph::connectionDeleted, this, onChanged);
+    connect(m_subGraph.get(), &CustomGraph::nodeUpdated, this, onChanged);
+    connect(m_subGraph.get(), &CustomGraph::batchCommitted, this, onChanged);
+}
+
+void CompositeModel::updatePorts()
+{
+    setPortNumber<DataNode>(PortType::In, boundaryNodes(composite_names::INPUT).size());
+    auto outputs = boundaryNodes(composite_names::OUTPUT);
+    setPortNumber<DataNode>(PortType::Out, outputs.size());
+    for (PortIndex i = 0; i < outputs.size(); ++i)
+        if (portCaption(PortType::Out, i) != outputs.at(i).second)
+            setPortCaption(PortType::Out, i, outputs.at(i).second);
+}
+
+void CompositeModel::updateOutputTypes()
+{
+    if (!m_subGraph)
+        return;
+    auto outputs = boundaryNodes(composite_names::OUTPUT);
+    bool changed = false;
+    for (PortIndex i = 0; i < outputs.size(); ++i) {
+        auto output = m_subGraph->delegateModel<FdfBlockModel>(outputs.at(i).first);
+        auto data = std::dynamic_pointer_cast<DataNode>(output->portData(PortType::In, 0));
+        auto port = outPort<DataNode>(i);
+        auto typeId = data ? data->typeId() : UIDManager::NONE_ID;
+        if (port && port->typeId() != typeId) {
+            port->setTypeId(typeId);
+            changed = true;
+        }
+    }
+    if (changed)
+        propagateUpdate();
+}
+
+std::vector<std::pair<QtNodes::NodeId, QString>> CompositeModel::boundaryNodes(
+    const QString &name) const
+{
+    if (!m_subGraph)
+        return savedBoundaryNodes(m_pipeline, name);
+    std::vector<std::pair<QtNodes::NodeId, QString>> result;
+    for (const auto &id : m_subGraph->allNodeIds())
+        if (auto block = m_subGraph->delegateModel<FdfBlockModel>(id); block->name() == name)
+            result.emplace_back(id, block->caption());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::unique_ptr<CustomGraph> CompositeModel::makeSubGraph(bool edited) const
+{
+    auto interner = m_parentGraph ? m_parentGraph->interner() : std::make_shared<StringInterner>();
+    auto graph = std::make_unique<CustomGraph>(BlockManager::getRegistry(), interner);
+    if (edited && m_parentGraph)
+        graph->setUIDManager(m_parentGraph->uidManager());
+    return graph;
+}
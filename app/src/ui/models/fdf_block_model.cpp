@@ -1,10 +1,13 @@
 #include "ui/models/fdf_block_model.hpp"
 #include "data/constants.hpp"
 #include "data/tab_manager.hpp"
+#include "logging_categories.hpp"
 #include <QAbstractButton>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QMessageBox>
+#include <QMetaMethod>
+#include <QtNodes/StyleCollection>
 
 FdfBlockModel::FdfBlockModel(FdfType type, const QString &name, const QString &functionName)
     : NodeDelegateModel()
@@ -12,7 +15,6 @@ FdfBlockModel::FdfBlockModel(FdfType type, const QString &name, const QString &f
     , m_name(name)
     , m_functionName(functionName)
     , m_caption(name)
-    , m_label(nullptr)
 {
     updateStyle();
     updateShape();
@@ -29,18 +31,12 @@ unsigned int FdfBlockModel::nPorts(PortType const portType) const
 
 bool FdfBlockModel::hasDataOutPorts()
 {
-    for (const auto &port : m_outPorts)
-        if (std::dynamic_pointer_cast<DataNode>(port.first))
-            return true;
-    return false;
+    return !m_outPortsByKind[DataPort].empty();
 }
 
 bool FdfBlockModel::hasFunctionOutPorts()
 {
-    for (const auto &port : m_outPorts)
-        if (std::dynamic_pointer_cast<FunctionNode>(port.first))
-            return true;
-    return false;
+    return !m_outPortsByKind[FunctionPort].empty();
 }
 
 NodeDataType FdfBlockModel::dataType(PortType const portType, PortIndex const portIndex) const
@@ -48,9 +44,9 @@ NodeDataType FdfBlockModel::dataType(PortType const portType, PortIndex const po
     if (!indexCheck(portType, portIndex))
         return NodeDataType();
     if (portType == PortType::In)
-        return m_inPorts.at(portIndex).first->type();
+        return m_inPorts.at(portIndex).structure->type();
     if (portType == PortType::Out)
-        return m_outPorts.at(portIndex).first->type();
+        return m_outPorts.at(portIndex).data->type();
     return NodeDataType();
 }
 
@@ -58,7 +54,7 @@ std::shared_ptr<NodeData> FdfBlockModel::outData(PortIndex const index)
 {
     if (!indexCheck(PortType::Out, index))
         return std::shared_ptr<NodeData>();
-    return m_outPorts.at(index).first;
+    return m_outPorts.at(index).data;
 }
 
 void FdfBlockModel::setInData(std::shared_ptr<NodeData> data, PortIndex const index)
@@ -68,47 +64,68 @@ void FdfBlockModel::setInData(std::shared_ptr<NodeData> data, PortIndex const in
     if (!data) {
         // delete the data and reset the port names accordingly
         emit dataInvalidated(index);
-        m_inPorts.at(index).second = std::weak_ptr<NodeData>();
+        m_inPorts.at(index).connected = std::weak_ptr<NodeData>();
         resetPortCaption(PortType::In, index);
-        if (auto casted = getInputPortAt<FunctionNode>(index))
+        if (m_inPorts.at(index).kind == FunctionPort)
             onFunctionInputReset(index);
-        else if (auto casted = getInputPortAt<DataNode>(index))
+        else
             onDataInputReset(index);
         return;
     }
-    m_inPorts.at(index).second = data;
+    auto named = std::dynamic_pointer_cast<NamedNode>(data);
+    if (!named || named->descriptor().kind != m_inPorts.at(index).kind) {
+        qCWarning(lcTyping) << caption() << ": ignored data of another kind at in port" << index;
+        return;
+    }
+    m_inPorts.at(index).connected = data;
     setPortCaption(PortType::In, index, data->type().name);
-    if (auto casted = std::dynamic_pointer_cast<FunctionNode>(data))
+    if (m_inPorts.at(index).kind == FunctionPort)
         onFunctionInputSet(index);
-    else if (auto casted = std::dynamic_pointer_cast<DataNode>(data))
+    else
         onDataInputSet(index);
     propagateUpdate();
 }
 
-QWidget *FdfBlockModel::embeddedWidget()
+QRectF FdfBlockModel::contentRect(const QSizeF &blockSize) const
 {
-    if (!m_label) {
-        // Enables resizing of the block
-        m_label = new QLabel();
-        m_label->setAlignment(Qt::AlignCenter);
-        m_label->setStyleSheet("QLabel{ background: transparent; }");
-    }
-    return m_label;
+    auto size = contentSize();
+    return QRectF(CONTENT_MARGIN,
+                  blockSize.height() - size.height() - CONTENT_MARGIN,
+                  blockSize.width() - 2 * CONTENT_MARGIN,
+                  size.height());
 }
 
-bool FdfBlockModel::checkBlockValidity() const
+QStringList FdfBlockModel::validityIssues() const
 {
     // check if all input ports are connected.
+    QStringList issues;
     int index = 0;
-    for (const auto &portPair : m_inPorts) {
-        if (!portPair.second.lock()) {
-            qWarning() << "Input port at index " << index << " of block " << this->caption()
-                       << " is not connected.";
-            return false;
+    for (const auto &port : m_inPorts) {
+        auto connected = port.connected.lock();
+        if (!connected) {
+            issues << QString("Input port at index %1 of block %2 is not connected.")
+                          .arg(index)
+                          .arg(caption());
+        } else {
+            auto dataNode = std::dynamic_pointer_cast<DataNode>(connected);
+            if (dataNode && dataNode->isChunked() && !acceptsChunkedInput())
+                issues << QString("Input port at index %1 of block %2 receives chunked data but "
+                                  "the block cannot stream it.")
+                              .arg(index)
+                              .arg(caption());
         }
         index++;
     }
-    return true;
+    return issues;
+}
+
+void FdfBlockModel::setInvalidHighlight(bool invalid)
+{
+    auto style = nodeStyle();
+    const auto &defaultStyle = QtNodes::StyleCollection::nodeStyle();
+    style.NormalBoundaryColor = invalid ? style.ErrorColor : defaultStyle.NormalBoundaryColor;
+    style.PenWidth = invalid ? 2 * defaultStyle.PenWidth : defaultStyle.PenWidth;
+    setNodeStyle(style);
 }
 
 QString FdfBlockModel::portCaption(PortType portType, PortIndex portIndex) const
@@ -116,12 +133,12 @@ QString FdfBlockModel::portCaption(PortType portType, PortIndex portIndex) const
     if (!indexCheck(portType, portIndex))
         return QString();
     if (portType == PortType::In) {
-        if (auto referencedPort = m_inPorts.at(portIndex).second.lock())
+        if (auto referencedPort = m_inPorts.at(portIndex).connected.lock())
             return referencedPort->type().name; // if there's a referenced port, use that caption
-        return m_inPorts.at(portIndex).first->type().name; // otherwise use the default
+        return m_inPorts.at(portIndex).structure->type().name; // otherwise use the default
     }
     if (portType == PortType::Out)
-        return m_outPorts.at(portIndex).first->type().name;
+        return m_outPorts.at(portIndex).data->type().name;
     return QString();
 }
 
@@ -131,15 +148,14 @@ QString FdfBlockModel::defaultPortCaption(PortType portType, PortIndex portIndex
         return QString();
     if (portType == PortType::In) {
         if (auto referencedNamedNode = std::dynamic_pointer_cast<NamedNode>(
-                m_inPorts.at(portIndex).second.lock()))
+                m_inPorts.at(portIndex).connected.lock()))
             // if there's a referenced port, use that caption
             return referencedNamedNode->defaultName();
-        else if (auto namedNode = dynamic_cast<NamedNode *>(m_inPorts.at(portIndex).first.get()))
-            namedNode->defaultName(); // otherwise use the default
+        else
+            return m_inPorts.at(portIndex).structure->defaultName(); // otherwise the default
     }
     if (portType == PortType::Out)
-        if (auto namedNode = std::dynamic_pointer_cast<NamedNode>(m_outPorts.at(portIndex).first))
-            return namedNode->defaultName();
+        return m_outPorts.at(portIndex).data->defaultName();
     return QString();
 }
 
@@ -161,14 +177,15 @@ QJsonObject FdfBlockModel::save() const
         QJsonObject portJson;
         portJson["index"] = static_cast<int>(i);
 
-        if (auto dataPort = const_cast<FdfBlockModel *>(this)->castedPort<DataNode>(PortType::Out,
-                                                                                    i)) {
+        if (auto dataPort = outPort<DataNode>(i)) {
             portJson["type_tag"] = dataPort->typeTagName();
             portJson["annotation"] = dataPort->annotation();
-        } else if (auto funcPort = const_cast<FdfBlockModel *>(this)
-                                       ->castedPort<FunctionNode>(PortType::Out, i)) {
+        } else if (auto funcPort = outPort<FunctionNode>(i)) {
             portJson["caption"] = funcPort->name();
         }
+        const auto &namedPort = m_outPorts.at(i).data;
+        if (namedPort->persistence() != NamedNode::Persistence::Default)
+            portJson["persistence"] = namedPort->persistenceString();
         outputPortsJson.append(portJson);
     }
     modelJson["output_ports"] = outputPortsJson;
@@ -200,9 +217,9 @@ std::shared_ptr<NodeData> FdfBlockModel::portData(PortType const type, PortIndex
     if (!indexCheck(type, index))
         return std::shared_ptr<NodeData>();
     if (type == PortType::In)
-        return m_inPorts.at(index).second.lock();
+        return m_inPorts.at(index).connected.lock();
     if (type == PortType::Out)
-        return m_outPorts.at(index).first;
+        return m_outPorts.at(index).data;
     return std::shared_ptr<NodeData>();
 }
 
@@ -212,13 +229,13 @@ std::vector<std::shared_ptr<NodeData>> FdfBlockModel::connectedPortData(PortType
     if (type == PortType::None)
         return result;
     if (type == PortType::In) {
-        for (auto &portPair : m_inPorts)
-            if (auto block = portPair.second.lock())
+        for (auto &port : m_inPorts)
+            if (auto block = port.connected.lock())
                 result.push_back(block);
     } else if (type == PortType::Out) {
-        for (auto &portPair : m_outPorts)
-            if (portPair.second) // second represents it's in use
-                result.push_back(portPair.first);
+        for (auto &port : m_outPorts)
+            if (port.inUse)
+                result.push_back(port.data);
     }
     return result;
 }
@@ -228,7 +245,7 @@ void FdfBlockModel::outputConnectionCreated(ConnectionId const &conn)
     PortIndex index = conn.outPortIndex;
     if (!indexCheck(PortType::Out, index))
         return;
-    m_outPorts.at(index).second = true;
+    m_outPorts.at(index).inUse = true;
 }
 
 void FdfBlockModel::outputConnectionDeleted(ConnectionId const &conn)
@@ -236,17 +253,17 @@ void FdfBlockModel::outputConnectionDeleted(ConnectionId const &conn)
     PortIndex index = conn.outPortIndex;
     if (!indexCheck(PortType::Out, index))
         return;
-    m_outPorts.at(index).second = false;
+    m_outPorts.at(index).inUse = false;
 }
 
 void FdfBlockModel::setInputPortNumber(uint num)
 {
-    qDebug() << "Input port number cannot be modified";
+    qCDebug(lcGraph) << "Input port number cannot be modified";
 }
 
 void FdfBlockModel::setOutputPortNumber(uint num)
 {
-    qDebug() << "Output port number cannot be modified";
+    qCDebug(lcGraph) << "Output port number cannot be modified";
 }
 
 void FdfBlockModel::onFunctionInputSet(const PortIndex &index) {}
@@ -266,10 +283,23 @@ bool FdfBlockModel::indexCheck(PortType type, PortIndex index) const
     return false;
 }
 
+PortKind FdfBlockModel::kindAt(PortType type, PortIndex index) const
+{
+    if (!indexCheck(type, index))
+        return DataPort;
+    return type == PortType::In ? m_inPorts[index].kind : m_outPorts[index].kind;
+}
+
 void FdfBlockModel::propagateUpdate()
 {
-    for (uint i = 0; i < nPorts(PortType::Out); ++i)
-        emit dataUpdated(i);
+    // repeated requests are coalesced by the graph before dataUpdated is emitted, a block
+    // outside a graph pushes its outputs right away
+    if (!isSignalConnected(QMetaMethod::fromSignal(&FdfBlockModel::propagationRequested))) {
+        for (PortIndex i = 0; i < nPorts(PortType::Out); ++i)
+            emit dataUpdated(i);
+        return;
+    }
+    emit propagationRequested();
 }
 
 void FdfBlockModel::setCaption(const QString &caption)
@@ -363,7 +393,7 @@ std::shared_ptr<NodeData> FdfBlockModel::inData(PortIndex const index)
 {
     if (!indexCheck(PortType::In, index))
         return std::shared_ptr<NodeData>();
-    return m_inPorts.at(index).second.lock();
+    return m_inPorts.at(index).connected.lock();
 }
 
 std::unordered_map<QString, QString> FdfBlockModel::getParameters() const
@@ -371,9 +401,9 @@ std::unordered_map<QString, QString> FdfBlockModel::getParameters() const
     return std::unordered_map<QString, QString>();
 }
 
-std::unordered_map<QString, QMetaType::Type> FdfBlockModel::getParameterSchema() const
+ParameterSchema FdfBlockModel::getParameterSchema() const
 {
-    return std::unordered_map<QString, QMetaType::Type>();
+    return ParameterSchema();
 }
 
 QStringList FdfBlockModel::getParameterOptions(const QString &key) const
@@ -383,21 +413,32 @@ QStringList FdfBlockModel::getParameterOptions(const QString &key) const
 
 void FdfBlockModel::setParameter(const QString &key, const QString &value) {}
 
-unsigned int FdfBlockModel::nPorts(const PortType &portType, const QString &typeId) const
+void FdfBlockModel::updateParameter(const QString &key, const QString &value)
+{
+    setParameter(key, value);
+    emit parameterUpdated(key);
+}
+
+unsigned int FdfBlockModel::nPorts(const PortType &portType, PortKind kind) const
 {
-    uint result = 0;
     if (portType == PortType::In)
-        for (auto &pair : m_inPorts)
-            if (pair.first.get()->type().id == typeId)
-                ++result;
+        return m_inPortsByKind[kind].size();
     if (portType == PortType::Out)
-        for (auto &pair : m_outPorts)
-            if (pair.first.get()->type().id == typeId)
-                ++result;
-    return result;
+        return m_outPortsByKind[kind].size();
+    return 0;
 }
 
-unsigned int FdfBlockModel::minModifiablePorts(const PortType &portType, const QString &typeId) const
+void FdfBlockModel::updatePortKindIndices(PortType type)
+{
+    auto &indices = type == PortType::In ? m_inPortsByKind : m_outPortsByKind;
+    for (auto &kindIndices : indices)
+        kindIndices.clear();
+    PortIndex count = type == PortType::In ? m_inPorts.size() : m_outPorts.size();
+    for (PortIndex i = 0; i < count; ++i)
+        indices[type == PortType::In ? m_inPorts[i].kind : m_outPorts[i].kind].push_back(i);
+}
+
+unsigned int FdfBlockModel::minModifiablePorts(const PortType &portType, PortKind kind) const
 {
     return 0;
 }
@@ -424,6 +465,58 @@ bool FdfBlockModel::canConnect(ConnectionInfo &connInfo) const
     return true;
 }
 
+bool FdfBlockModel::verifyConnection(ConnectionInfo &connInfo) const
+{
+    if (connInfo.receivedChunked && !acceptsChunkedInput()) {
+        warnInvalidConnection(connInfo, constants::CHUNKED_INPUT);
+        return false;
+    }
+    return canConnect(connInfo);
+}
+
+bool FdfBlockModel::acceptsConnection(const PortDescriptor &source, PortIndex inIndex) const
+{
+    Q_UNUSED(inIndex);
+    return !source.chunked || acceptsChunkedInput();
+}
+
+PortDescriptor FdfBlockModel::outPortDescriptor(PortIndex index) const
+{
+    if (!indexCheck(PortType::Out, index))
+        return {DataPort};
+    return m_outPorts.at(index).data->descriptor();
+}
+
+bool FdfBlockModel::hasChunkedInput() const
+{
+    for (const auto &index : m_inPortsByKind[DataPort])
+        if (auto dataNode = std::dynamic_pointer_cast<DataNode>(m_inPorts[index].connected.lock()))
+            if (dataNode->isChunked())
+                return true;
+    return false;
+}
+
+void FdfBlockModel::setNodeId(const NodeId &id)
+{
+    m_nodeId = id;
+    for (auto &port : allOutData<NamedNode>())
+        port->setOwnerId(id);
+}
+
+PortIndex FdfBlockModel::outPortIndex(const NodeData *port) const
+{
+    for (size_t i = 0; i < m_outPorts.size(); ++i)
+        if (m_outPorts.at(i).data.get() == port)
+            return i;
+    return QtNodes::InvalidPortIndex;
+}
+
+void FdfBlockModel::setOutputChunked(bool chunked)
+{
+    for (auto &dataNode : allOutData<DataNode>())
+        dataNode->setChunked(chunked);
+}
+
 bool FdfBlockModel::warnInvalidConnection(ConnectionInfo connInfo, const QString &message) const
 {
     // since the calls are on the same thread, direct call works
@@ -457,12 +550,12 @@ bool FdfBlockModel::showWarning(ConnectionInfo connInfo, const QString &message)
             return true;
         }
 
-    } else if (message == constants::SINGULAR_SIGNATURE) {
+    } else if (message == constants::SINGULAR_SIGNATURE || message == constants::CHUNKED_INPUT) {
         msgBox.setInformativeText(message);
         msgBox.exec();
 
     } else {
-        qWarning() << "Unknown connection warning message: " << message;
+        qCWarning(lcTyping) << "Unknown connection warning message: " << message;
     }
     return false;
 }
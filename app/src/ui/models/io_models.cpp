@@ -1,9 +1,10 @@
 #include "ui/models/io_models.hpp"
 #include "data/tab_manager.hpp"
+#include "logging_categories.hpp"
 
-#include <QLabel>
-#include <QPushButton>
-#include <QVBoxLayout>
+#include <QPainter>
+
+#include <algorithm>
 
 namespace {
 
@@ -11,6 +12,8 @@ std::unordered_map<CatalogType, QString> CATALOG_STRING = {
     {CatalogType::Pickle, "pickle.PickleDataset"},
     {CatalogType::Csv, "pandas.CSVDataset"},
     {CatalogType::H5, "kedro_umbrella.library.H5Dataset"},
+    {CatalogType::Parquet, "pandas.ParquetDataset"},
+    {CatalogType::Feather, "pandas.FeatherDataset"},
 };
 
 std::unordered_map<QString, CatalogType> CATALOG_EXTENSIONS = {
@@ -19,37 +22,99 @@ std::unordered_map<QString, CatalogType> CATALOG_EXTENSIONS = {
     {"pkl", CatalogType::Pickle},
     {"mat", CatalogType::H5},
     {"jld2", CatalogType::H5},
+    {"parquet", CatalogType::Parquet},
+    {"feather", CatalogType::Feather},
+};
+
+// extension used when writing a catalog type, several extensions may map to the same type
+std::unordered_map<CatalogType, QString> CATALOG_DEFAULT_EXTENSION = {
+    {CatalogType::Pickle, "pkl"},
+    {CatalogType::Csv, "csv"},
+    {CatalogType::H5, "mat"},
+    {CatalogType::Parquet, "parquet"},
+    {CatalogType::Feather, "feather"},
+};
+
+std::unordered_map<Codec, QString> CODEC_STRING = {
+    {Codec::Uncompressed, "none"},
+    {Codec::Lz4, "lz4"},
+    {Codec::Zstd, "zstd"},
 };
 
+std::optional<CatalogType> catalogTypeFromString(const QString &value)
+{
+    for (auto &pair : CATALOG_DEFAULT_EXTENSION)
+        if (pair.second == value)
+            return pair.first;
+    if (CATALOG_EXTENSIONS.count(value) > 0)
+        return CATALOG_EXTENSIONS.at(value);
+    return std::nullopt;
+}
+
+// file name on the first line, import button on the second
+constexpr int CONTENT_LINE_HEIGHT = 22;
+constexpr int IMPORT_BUTTON_WIDTH = 64;
+// largest a graph is shown inside its block
+constexpr int MAX_GRAPH_WIDTH = 320;
+constexpr int MAX_GRAPH_HEIGHT = 240;
+
+QRectF importButtonRect(const QRectF &content)
+{
+    return QRectF(content.center().x() - IMPORT_BUTTON_WIDTH / 2,
+                  content.top() + CONTENT_LINE_HEIGHT,
+                  IMPORT_BUTTON_WIDTH,
+                  CONTENT_LINE_HEIGHT - 2);
+}
+
+constexpr ParameterDescriptor OUTPUT_PARAMETERS[] = {
+    {&OutputModel::FILE_TYPE, QMetaType::QString},
+    {&OutputModel::CODEC, QMetaType::QString},
+    {&OutputModel::COMPRESSION_LEVEL, QMetaType::Int},
+};
+constexpr ParameterDescriptor DATA_SOURCE_PARAMETERS[] = {
+    {&DataSourceModel::CHUNK_SIZE, QMetaType::Int},
+};
+constexpr ParameterDescriptor H5_DATA_SOURCE_PARAMETERS[] = {
+    {&DataSourceModel::CHUNK_SIZE, QMetaType::Int},
+    {&DataSourceModel::DATASET, QMetaType::QString},
+    {&DataSourceModel::ROWS, QMetaType::QString},
+};
 } // namespace
 
 DataSourceModel::DataSourceModel()
     : FdfBlockModel(FdfType::Data, io_names::DATA_SOURCE)
-    , m_widget(nullptr)
-    , m_label(nullptr)
 {}
 
-QWidget *DataSourceModel::embeddedWidget()
+QSize DataSourceModel::contentSize() const
 {
-    if (!m_widget) {
-        m_widget = new QWidget();
-        m_widget->setProperty("bg", "transparent");
-        m_widget->setStyleSheet("*[bg='transparent']{ background: transparent; }");
-
-        auto layout = new QVBoxLayout(m_widget);
-        layout->setSpacing(0);
-        layout->setContentsMargins(0, 0, 0, 0);
-
-        m_label = new QLabel(portCaption(PortType::Out, 0));
-        layout->addWidget(m_label);
-
-        auto button = new QPushButton("Import");
-        layout->addWidget(button);
+    return QSize(IMPORT_BUTTON_WIDTH * 2, CONTENT_LINE_HEIGHT * 2);
+}
 
-        connect(button, &QPushButton::clicked, this, &DataSourceModel::importClicked);
-    }
+void DataSourceModel::paintContent(QPainter *painter, const QRectF &rect) const
+{
+    // colours of the node style, so the content follows the scene theme and not the desktop
+    const auto &style = nodeStyle();
+    QRectF nameRect(rect.topLeft(), QSizeF(rect.width(), CONTENT_LINE_HEIGHT));
+    auto name = m_file.fileName().isEmpty() ? portCaption(PortType::Out, 0) : m_file.fileName();
+    painter->setPen(style.FontColor);
+    painter->drawText(nameRect,
+                      Qt::AlignCenter,
+                      painter->fontMetrics().elidedText(name, Qt::ElideMiddle, rect.width()));
+
+    auto button = importButtonRect(rect);
+    painter->setPen(style.FontColorFaded);
+    painter->setBrush(style.GradientColor0);
+    painter->drawRoundedRect(button, 4, 4);
+    painter->setPen(style.FontColor);
+    painter->drawText(button, Qt::AlignCenter, "Import");
+}
 
-    return m_widget;
+bool DataSourceModel::contentPressed(const QPointF &position, const QSizeF &size)
+{
+    if (!importButtonRect(QRectF(QPointF(), size)).contains(position))
+        return false;
+    emit importClicked();
+    return true;
 }
 
 QJsonObject DataSourceModel::save() const
@@ -84,13 +149,14 @@ void DataSourceModel::setFile(const QFileInfo &file)
     if (file == m_file)
         return;
     m_file = file;
+    m_h5Datasets.reset();
     if (CATALOG_EXTENSIONS.count(m_file.suffix()) > 0)
         m_fileType = CATALOG_EXTENSIONS.at(m_file.suffix());
-    if (m_label)
-        m_label->setText(m_file.fileName());
+    emit paintedContentUpdated();
     // Create an output data port based on the name of file imported
     auto newTag = m_file.baseName();
     addPort<DataNode>(PortType::Out, newTag);
+    updateChunking();
     emit contentUpdated();
 }
 
@@ -110,73 +176,273 @@ QString DataSourceModel::outPortCaption()
     return "";
 }
 
-bool DataSourceModel::checkBlockValidity() const
+QStringList DataSourceModel::validityIssues() const
 {
     // Check if the file is set and has a valid type
-    if (m_file.fileName().isEmpty()) {
-        qWarning() << "DataSourceModel: No file set.";
-        return false;
+    QStringList issues;
+    if (m_file.fileName().isEmpty())
+        issues << QString("%1: No file set.").arg(caption());
+    if (m_fileType == CatalogType::H5 && !m_h5Rows.isEmpty()) {
+        auto range = data::H5Browser::parseRange(m_h5Rows);
+        if (!range) {
+            issues << QString("%1: invalid row range %2, expected start:stop.")
+                          .arg(caption(), m_h5Rows);
+            return issues;
+        }
+        // without a selected dataset the range applies to every dataset of the file
+        for (auto &dataset : h5Datasets()) {
+            if (!m_h5Dataset.isEmpty() && dataset.path != m_h5Dataset)
+                continue;
+            // scalars have no rows, the range is not applied to them
+            if (dataset.isScalar())
+                continue;
+            auto rows = dataset.shape.front();
+            if (range->first >= rows || range->second.value_or(0) > rows)
+                issues << QString("%1: row range %2 exceeds the %3 rows of %4")
+                              .arg(caption(), m_h5Rows)
+                              .arg(rows)
+                              .arg(dataset.path);
+        }
     }
-    return true;
+    return issues;
 }
 
-FuncOutModel::FuncOutModel()
-    : FdfBlockModel(FdfType::Output, io_names::FUNC_OUT)
-    , m_fileType(CatalogType::Pickle)
-{
-    addPort<FunctionNode>(PortType::In);
-}
+OutputModel::OutputModel(const QString &name, const std::vector<CatalogType> &supportedTypes)
+    : FdfBlockModel(FdfType::Output, name)
+    , m_supportedTypes(supportedTypes)
+    , m_fileType(supportedTypes.front())
+{}
 
-QString FuncOutModel::fileTypeString() const
+QString OutputModel::fileTypeString() const
 {
     if (CATALOG_STRING.count(m_fileType) > 0)
         return CATALOG_STRING.at(m_fileType);
     return "NONE";
 }
 
-QString FuncOutModel::getFileName() const
+void OutputModel::setFileType(const CatalogType &fileType)
+{
+    if (std::find(m_supportedTypes.begin(), m_supportedTypes.end(), fileType)
+        == m_supportedTypes.end()) {
+        qCWarning(lcIo) << "Unsupported file type for" << caption() << ":"
+                        << CATALOG_DEFAULT_EXTENSION.at(fileType);
+        return;
+    }
+    m_fileType = fileType;
+}
+
+QString OutputModel::getFileName() const
 {
     return portCaption(PortType::In, 0);
 }
 
-QString FuncOutModel::getFileExtenstion() const
+QString OutputModel::getFileExtenstion() const
 {
-    for (auto &pair : CATALOG_EXTENSIONS)
-        if (pair.second == m_fileType)
-            return pair.first;
+    if (CATALOG_DEFAULT_EXTENSION.count(m_fileType) > 0)
+        return CATALOG_DEFAULT_EXTENSION.at(m_fileType);
     return QString();
 }
 
-DataOutModel::DataOutModel()
-    : FdfBlockModel(FdfType::Output, io_names::DATA_OUT)
-    , m_fileType(CatalogType::Pickle)
+QString OutputModel::codecString() const
 {
-    addPort<DataNode>(PortType::In);
+    return CODEC_STRING.at(m_codec);
 }
 
-QString DataOutModel::fileTypeString() const
+void OutputModel::setCodec(const Codec &codec)
 {
-    if (CATALOG_STRING.count(m_fileType) > 0)
-        return CATALOG_STRING.at(m_fileType);
-    return "NONE";
+    m_codec = codec;
+    setCompressionLevel(m_compressionLevel);
 }
 
-QString DataOutModel::getFileName() const
+void OutputModel::setCompressionLevel(int level)
 {
-    return portCaption(PortType::In, 0);
+    // levels accepted by arrow for each codec
+    switch (m_codec) {
+    case Codec::Lz4:
+        level = std::clamp(level, 1, 12);
+        break;
+    case Codec::Zstd:
+        level = std::clamp(level, 1, 22);
+        break;
+    default:
+        break;
+    }
+    m_compressionLevel = level;
 }
 
-QString DataOutModel::getFileExtenstion() const
+std::unordered_map<QString, QString> OutputModel::getParameters() const
 {
-    for (auto &pair : CATALOG_EXTENSIONS)
-        if (pair.second == m_fileType)
-            return pair.first;
-    return QString();
+    std::unordered_map<QString, QString> result;
+    result[FILE_TYPE] = getFileExtenstion();
+    result[CODEC] = codecString();
+    result[COMPRESSION_LEVEL] = QString::number(m_compressionLevel);
+    return result;
+}
+
+ParameterSchema OutputModel::getParameterSchema() const
+{
+    return OUTPUT_PARAMETERS;
+}
+
+QStringList OutputModel::getParameterOptions(const QString &key) const
+{
+    QStringList result;
+    if (key == FILE_TYPE)
+        for (auto &type : m_supportedTypes)
+            result << CATALOG_DEFAULT_EXTENSION.at(type);
+    else if (key == CODEC)
+        result << CODEC_STRING.at(Codec::Uncompressed) << CODEC_STRING.at(Codec::Lz4)
+               << CODEC_STRING.at(Codec::Zstd);
+    return result;
+}
+
+void OutputModel::setParameter(const QString &key, const QString &value)
+{
+    if (key == FILE_TYPE) {
+        if (auto fileType = catalogTypeFromString(value))
+            setFileType(fileType.value());
+    } else if (key == CODEC) {
+        for (auto &pair : CODEC_STRING)
+            if (pair.second == value)
+                setCodec(pair.first);
+    } else if (key == COMPRESSION_LEVEL) {
+        setCompressionLevel(value.toInt());
+    }
+}
+
+std::unordered_map<QString, QString> DataSourceModel::getParameters() const
+{
+    std::unordered_map<QString, QString> result;
+    result[CHUNK_SIZE] = QString::number(m_chunkSize);
+    if (m_fileType == CatalogType::H5) {
+        result[DATASET] = m_h5Dataset.isEmpty() ? ALL_DATASETS : m_h5Dataset;
+        result[ROWS] = m_h5Rows;
+    }
+    return result;
+}
+
+ParameterSchema DataSourceModel::getParameterSchema() const
+{
+    if (m_fileType == CatalogType::H5)
+        return H5_DATA_SOURCE_PARAMETERS;
+    return DATA_SOURCE_PARAMETERS;
+}
+
+QStringList DataSourceModel::getParameterOptions(const QString &key) const
+{
+    QStringList result;
+    if (key == DATASET && m_fileType == CatalogType::H5) {
+        result << ALL_DATASETS;
+        for (auto &dataset : h5Datasets())
+            result << dataset.path;
+        // keep a selection made on a machine that could browse the file
+        if (!m_h5Dataset.isEmpty() && !result.contains(m_h5Dataset))
+            result << m_h5Dataset;
+    }
+    return result;
+}
+
+void DataSourceModel::setParameter(const QString &key, const QString &value)
+{
+    if (key == CHUNK_SIZE)
+        setChunkSize(value.toInt());
+    else if (key == DATASET)
+        setH5Dataset(value);
+    else if (key == ROWS)
+        setH5Rows(value);
+}
+
+const std::vector<data::H5DatasetInfo> &DataSourceModel::h5Datasets() const
+{
+    if (!m_h5Datasets) {
+        m_h5Datasets.emplace();
+        if (m_fileType == CatalogType::H5 && data::H5Browser::isAvailable())
+            m_h5Datasets = data::H5Browser::listDatasets(absoluteFilePath());
+    }
+    return m_h5Datasets.value();
+}
+
+void DataSourceModel::setH5Dataset(const QString &path)
+{
+    m_h5Dataset = path == ALL_DATASETS ? QString() : path;
+}
+
+QString DataSourceModel::absoluteFilePath() const
+{
+    if (m_file.isAbsolute() && m_file.exists())
+        return m_file.absoluteFilePath();
+    // loaded projects only store the file name, the file lives in the data dir of the block's tab
+    auto tab = TabManager::instance().getTab(this);
+    if (!tab)
+        tab = TabManager::instance().getCurrentTab();
+    if (tab)
+        return tab->getDataDir().absoluteFilePath(m_file.fileName());
+    return m_file.absoluteFilePath();
+}
+
+void DataSourceModel::setChunkSize(int chunkSize)
+{
+    chunkSize = std::max(chunkSize, 0);
+    if (chunkSize == m_chunkSize)
+        return;
+    m_chunkSize = chunkSize;
+    if (m_chunkSize > 0 && m_fileType && !supportsChunking())
+        qCWarning(lcIo) << caption() << ": chunked reads are not supported for" << fileTypeString()
+                        << ", the file will be loaded at once.";
+    updateChunking();
+}
+
+bool DataSourceModel::supportsChunking() const
+{
+    return m_fileType == CatalogType::Csv || m_fileType == CatalogType::H5;
+}
+
+std::vector<std::pair<QString, QString>> DataSourceModel::loadArgs() const
+{
+    std::vector<std::pair<QString, QString>> result;
+    if (m_fileType == CatalogType::H5) {
+        // H5Dataset only reads the selected dataset and hyperslab
+        if (!m_h5Dataset.isEmpty())
+            result.push_back({"dataset", constants::kedro::yamlQuote(m_h5Dataset)});
+        if (auto range = data::H5Browser::parseRange(m_h5Rows)) {
+            result.push_back({"start", QString::number(range->first)});
+            if (range->second)
+                result.push_back({"stop", QString::number(range->second.value())});
+        }
+    }
+    if (!isChunked())
+        return result;
+    // pandas yields a reader over blocks of rows, H5Dataset yields hyperslabs along the first axis
+    if (m_fileType == CatalogType::Csv)
+        result.push_back({"chunksize", QString::number(m_chunkSize)});
+    else if (m_fileType == CatalogType::H5)
+        result.push_back({"chunk_size", QString::number(m_chunkSize)});
+    return result;
+}
+
+void DataSourceModel::updateChunking()
+{
+    setOutputChunked(isChunked());
+    propagateUpdate();
+}
+
+// functions are arbitrary python objects, only pickle is able to hold them
+FuncOutModel::FuncOutModel()
+    : OutputModel(io_names::FUNC_OUT, {CatalogType::Pickle})
+{
+    addPort<FunctionNode>(PortType::In);
+}
+
+// columnar formats are only meaningful for tabular data
+DataOutModel::DataOutModel()
+    : OutputModel(io_names::DATA_OUT,
+                  {CatalogType::Pickle, CatalogType::Csv, CatalogType::Parquet, CatalogType::Feather})
+{
+    addPort<DataNode>(PortType::In);
 }
 
 GraphModel::GraphModel()
     : FdfBlockModel(FdfType::Output, io_names::GRAPH_FUNCTION)
-    , m_graph(nullptr)
 {
     addPort<FunctionNode>(PortType::In, "f");
 }
@@ -189,21 +455,34 @@ void GraphModel::setFile(const QFileInfo &file)
     updateGraph();
 }
 
-QWidget *GraphModel::embeddedWidget()
+QSize GraphModel::contentSize() const
 {
-    if (!m_graph) {
-        m_graph = new QLabel;
-        m_graph->setStyleSheet("QLabel{ background: transparent; }");
-        if (!m_file.absoluteFilePath().isEmpty())
-            m_graph->setPixmap(QPixmap(m_file.absoluteFilePath()));
-    }
-    return m_graph;
+    return m_graph.size();
 }
 
-void GraphModel::updateGraph()
+void GraphModel::paintContent(QPainter *painter, const QRectF &rect) const
 {
-    if (!m_graph)
+    if (m_graph.isNull())
         return;
-    m_graph->setPixmap(QPixmap(m_file.absoluteFilePath()));
+    // the pixmap is already at content size, only a narrower block scales it further
+    auto size = m_graph.size();
+    if (size.width() > rect.width() || size.height() > rect.height())
+        size.scale(rect.size().toSize(), Qt::KeepAspectRatio);
+    QRectF target(QPointF(), size);
+    target.moveCenter(rect.center());
+    painter->drawPixmap(target, m_graph, m_graph.rect());
+}
+
+void GraphModel::updateGraph()
+{
+    // scaled once here rather than on every paint, the full resolution file is not kept
+    QPixmap graph(m_file.absoluteFilePath());
+    if (graph.width() > MAX_GRAPH_WIDTH || graph.height() > MAX_GRAPH_HEIGHT)
+        graph = graph.scaled(MAX_GRAPH_WIDTH,
+                             MAX_GRAPH_HEIGHT,
+                             Qt::KeepAspectRatio,
+                             Qt::SmoothTransformation);
+    m_graph = graph;
+    emit paintedContentUpdated();
     emit contentUpdated();
 }
@@ -1,5 +1,62 @@
 #include "ui/models/nodes.hpp"
 
+namespace {
+using Persistence = NamedNode::Persistence;
+const std::vector<std::pair<Persistence, QString>> PERSISTENCE_STRING = {
+    {Persistence::Default, "default"},
+    {Persistence::Memory, "memory"},
+    {Persistence::Pickle, "pickle"},
+    {Persistence::Parquet, "parquet"},
+    {Persistence::CompressedPickle, "compressed_pickle"},
+};
+} // namespace
+
+QString NamedNode::persistenceString() const
+{
+    for (auto &pair : PERSISTENCE_STRING)
+        if (pair.first == m_persistence)
+            return pair.second;
+    return QString();
+}
+
+bool NamedNode::setPersistence(const QString &persistence)
+{
+    if (!persistenceOptions().contains(persistence))
+        return false;
+    for (auto &pair : PERSISTENCE_STRING)
+        if (pair.second == persistence) {
+            m_persistence = pair.first;
+            return true;
+        }
+    return false;
+}
+
+QStringList NamedNode::persistenceOptions() const
+{
+    // parquet only holds tabular data
+    QStringList result;
+    for (auto &pair : PERSISTENCE_STRING)
+        if (pair.first != Persistence::Parquet)
+            result << pair.second;
+    return result;
+}
+
+UIDManager *NamedNode::indexManager()
+{
+    if (!m_uidManager) {
+        m_uidManager = TabManager::getUIDManager();
+        m_uidManager->bindPort(this);
+    }
+    return m_uidManager;
+}
+
+NamedNode::~NamedNode()
+{
+    // the derived destructors have unindexed the port already
+    if (m_uidManager)
+        m_uidManager->releasePort(this);
+}
+
 DataNode::DataNode()
     : NamedNode("data")
 {
@@ -23,17 +80,24 @@ DataNode::DataNode(FdfUID typeId)
     : NamedNode("data")
 {
     m_type.id = constants::DATA_PORT_ID;
-    auto uidManager = TabManager::getUIDManager();
+    auto uidManager = indexManager();
     auto tag = uidManager->getTag(typeId);
     if (tag != UIDManager::NONE_TAG) {
         m_typeId = typeId;
         m_typeTagName = tag;
+        reindex(UIDManager::NONE_ID);
     } else {
         setParams("data");
     }
     updateDisplayName();
 }
 
+DataNode::~DataNode()
+{
+    if (m_uidManager)
+        m_uidManager->unindexPort(this, m_typeId);
+}
+
 FdfUID DataNode::typeId() const
 {
     return m_typeId;
@@ -42,16 +106,19 @@ FdfUID DataNode::typeId() const
 void DataNode::setTypeId(const FdfUID &typeId)
 {
     // Here, the intention is to use the existing type tag for the given type ID
-    auto uidManager = TabManager::getUIDManager();
+    auto uidManager = indexManager();
+    FdfUID previous = m_typeId;
     m_typeId = typeId;
     m_typeTagName = uidManager->getTag(m_typeId);
+    if (previous != m_typeId)
+        reindex(previous);
     updateDisplayName();
 }
 
 void DataNode::setTypeTagName(const QString &name)
 {
     // Here, the type tag for this port's type ID will be changed
-    auto uidManager = TabManager::getUIDManager();
+    auto uidManager = indexManager();
     m_typeTagName = constants::sanitizeCaption(name);
     uidManager->updateMap(m_typeId, m_typeTagName);
     updateDisplayName();
@@ -75,7 +142,7 @@ QString DataNode::annotation() const
 
 void DataNode::updateDisplayName()
 {
-    auto uidManager = TabManager::getUIDManager();
+    auto uidManager = indexManager();
     m_typeTagName = uidManager->getTag(m_typeId);
     m_type.name = m_annotation.isEmpty() ? m_typeTagName : m_typeTagName + "_" + m_annotation;
 }
@@ -86,11 +153,31 @@ void DataNode::setPlaceHolderCaption(QString typeTag, QString annot)
     m_type.name = annot.isEmpty() ? typeTag : typeTag + "_" + annot;
 }
 
+QStringList DataNode::persistenceOptions() const
+{
+    QStringList result;
+    for (auto &pair : PERSISTENCE_STRING)
+        result << pair.second;
+    return result;
+}
+
 void DataNode::setParams(const QString &name)
 {
-    auto uidManager = TabManager::getUIDManager();
+    auto uidManager = indexManager();
     m_typeId = uidManager->createUID(name);
     m_typeTagName = uidManager->getTag(m_typeId);
+    reindex(UIDManager::NONE_ID);
+}
+
+// in-port placeholders hold a type id like out ports, so they are indexed too and follow renames
+// and overrides of their type instead of keeping a stale tag
+void DataNode::reindex(FdfUID previous)
+{
+    if (previous == UIDManager::NONE_ID && m_typeId == UIDManager::NONE_ID)
+        return;
+    auto uidManager = indexManager();
+    uidManager->unindexPort(this, previous);
+    uidManager->indexPort(this, m_typeId, {PortRef::Data, 0});
 }
 
 FunctionNode::FunctionNode()
@@ -104,12 +191,44 @@ FunctionNode::FunctionNode(const QString &name)
     m_type.name = name;
 }
 
-Signature FunctionNode::signature() const
+FunctionNode::~FunctionNode()
+{
+    unindex();
+}
+
+const Signature &FunctionNode::signature() const
 {
-    return m_signature;
+    // the handle belongs to the table of the manager, a detached port has no signature left
+    static const Signature EMPTY;
+    if (!m_uidManager)
+        return EMPTY;
+    return m_uidManager->signatures().get(m_signatureId);
 }
 
 void FunctionNode::setSignature(const Signature &signature)
 {
-    m_signature = signature;
+    auto uidManager = indexManager();
+    auto signatureId = uidManager->signatures().intern(signature);
+    if (signatureId == m_signatureId)
+        return;
+    unindex();
+    m_signatureId = signatureId;
+    if (signatureId == SignatureTable::EMPTY_ID)
+        return;
+    const auto &interned = this->signature();
+    for (unsigned int i = 0; i < interned.inputs.size(); ++i)
+        uidManager->indexPort(this, interned.inputs.at(i), {PortRef::SignatureInput, i});
+    for (unsigned int i = 0; i < interned.outputs.size(); ++i)
+        uidManager->indexPort(this, interned.outputs.at(i), {PortRef::SignatureOutput, i});
+}
+
+void FunctionNode::unindex()
+{
+    if (!m_uidManager)
+        return;
+    const auto &current = signature();
+    for (const auto &uid : current.inputs)
+        m_uidManager->unindexPort(this, uid);
+    for (const auto &uid : current.outputs)
+        m_uidManager->unindexPort(this, uid);
 }
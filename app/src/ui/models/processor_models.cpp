@@ -8,6 +8,20 @@ std::unordered_map<Plot, QString> PLOT_STRING = {
     {Plot::Regression, "regression"},
     {Plot::TimeSeries, "time_series"},
 };
+constexpr ParameterDescriptor SPLIT_PARAMETERS[] = {
+    {&SplitDataModel::RANDOM_STATE, QMetaType::Int},
+    {&SplitDataModel::SPLIT_TIME, QMetaType::Int},
+    {&SplitDataModel::TRAIN_SIZE, QMetaType::Double},
+};
+constexpr ParameterDescriptor SCORE_PARAMETERS[] = {
+    {&ScoreModel::PLOT, QMetaType::QString},
+};
+constexpr ParameterDescriptor SENSITIVITY_PARAMETERS[] = {
+    {&SensitivityAnalysisModel::NUM_SAMPLE, QMetaType::Int},
+    {&SensitivityAnalysisModel::TARGET, QMetaType::Int},
+    {&SensitivityAnalysisModel::DIFF_STEP, QMetaType::Int},
+    {&SensitivityAnalysisModel::GRID_SIZE, QMetaType::Int},
+};
 } // namespace
 
 ProcessorModel::ProcessorModel(const QString &name, const QString &functionName)
@@ -19,13 +33,13 @@ bool ProcessorModel::portNumberModifiable(const PortType &portType) const
     return true;
 }
 
-uint ProcessorModel::minModifiablePorts(const PortType &portType, const QString &typeId) const
+uint ProcessorModel::minModifiablePorts(const PortType &portType, PortKind kind) const
 {
     if (portType == PortType::In)
-        if (typeId == constants::DATA_PORT_ID)
+        if (kind == DataPort)
             return 1;
     if (portType == PortType::Out)
-        if (typeId == constants::DATA_PORT_ID)
+        if (kind == DataPort)
             return 1;
     return 0;
 }
@@ -86,13 +100,9 @@ std::unordered_map<QString, QString> SplitDataModel::getParameters() const
     return result;
 }
 
-std::unordered_map<QString, QMetaType::Type> SplitDataModel::getParameterSchema() const
+ParameterSchema SplitDataModel::getParameterSchema() const
 {
-    std::unordered_map<QString, QMetaType::Type> schema;
-    schema[RANDOM_STATE] = QMetaType::Int;
-    schema[SPLIT_TIME] = QMetaType::Int;
-    schema[TRAIN_SIZE] = QMetaType::Double;
-    return schema;
+    return SPLIT_PARAMETERS;
 }
 
 void SplitDataModel::setParameter(const QString &key, const QString &value)
@@ -237,11 +247,9 @@ std::unordered_map<QString, QString> ScoreModel::getParameters() const
     return result;
 }
 
-std::unordered_map<QString, QMetaType::Type> ScoreModel::getParameterSchema() const
+ParameterSchema ScoreModel::getParameterSchema() const
 {
-    std::unordered_map<QString, QMetaType::Type> schema;
-    schema[PLOT] = QMetaType::QString;
-    return schema;
+    return SCORE_PARAMETERS;
 }
 
 QStringList ScoreModel::getParameterOptions(const QString &key) const
@@ -301,6 +309,7 @@ void DifferenceModel::onDataInputSet(const PortIndex &index)
         typeId = data->typeId();
         setOutputTypeId(0, typeId);
     }
+    setOutputChunked(hasChunkedInput());
 }
 
 void DifferenceModel::onDataInputReset(const PortIndex &index)
@@ -314,6 +323,8 @@ void DifferenceModel::onDataInputReset(const PortIndex &index)
     if (!castedPort<DataNode>(PortType::In, other)) {
         setOutputTypeId(0, UIDManager::NONE_ID);
     }
+    setOutputChunked(hasChunkedInput());
+    propagateUpdate();
 }
 
 void DifferenceModel::setOutputTypeId(const PortIndex &inputIndex, const FdfUID &typeId)
@@ -355,14 +366,9 @@ std::unordered_map<QString, QString> SensitivityAnalysisModel::getParameters() c
     return result;
 }
 
-std::unordered_map<QString, QMetaType::Type> SensitivityAnalysisModel::getParameterSchema() const
+ParameterSchema SensitivityAnalysisModel::getParameterSchema() const
 {
-    std::unordered_map<QString, QMetaType::Type> schema;
-    schema[NUM_SAMPLE] = QMetaType::Int;
-    schema[TARGET] = QMetaType::Int;
-    schema[DIFF_STEP] = QMetaType::Int;
-    schema[GRID_SIZE] = QMetaType::Int;
-    return schema;
+    return SENSITIVITY_PARAMETERS;
 }
 
 void SensitivityAnalysisModel::setParameter(const QString &key, const QString &value)
@@ -422,6 +428,14 @@ void SensitivityAnalysisModel::setOutputTypeId(const PortIndex &inputIndex, cons
     }
 }
 
+bool SensitivityAnalysisModel::acceptsConnection(const PortDescriptor &source,
+                                                 PortIndex inIndex) const
+{
+    if (source.kind != FunctionPort)
+        return ProcessorModel::acceptsConnection(source, inIndex);
+    return source.arity.first <= 1 && source.arity.second <= 1;
+}
+
 bool SensitivityAnalysisModel::canConnect(ConnectionInfo &connInfo) const
 {
     //check if the input function signature is singular (1 input, 1 output)
@@ -0,0 +1,36 @@
+#include "ui/models/signature_table.hpp"
+
+namespace {
+void combine(size_t &seed, size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+} // namespace
+
+size_t SignatureHash::operator()(const Signature &signature) const
+{
+    size_t seed = signature.inputs.size();
+    for (const auto &uid : signature.inputs)
+        combine(seed, std::hash<FdfUID>()(uid));
+    // keeps (a) => (b, c) and (a, b) => (c) apart
+    combine(seed, signature.outputs.size());
+    for (const auto &uid : signature.outputs)
+        combine(seed, std::hash<FdfUID>()(uid));
+    return seed;
+}
+
+SignatureTable::SignatureTable()
+{
+    intern(Signature());
+}
+
+SignatureId SignatureTable::intern(const Signature &signature)
+{
+    auto existing = m_ids.find(signature);
+    if (existing != m_ids.end())
+        return existing->second;
+    SignatureId id = m_signatures.size();
+    m_signatures.push_back(signature);
+    m_ids.emplace(signature, id);
+    return id;
+}
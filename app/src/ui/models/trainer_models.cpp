@@ -10,6 +10,16 @@ std::unordered_map<Model, QString> MODEL_STRING = {
     {Model::Dt, "dt"},
     {Model::Svr, "svr"},
 };
+constexpr ParameterDescriptor BASIC_TRAINER_PARAMETERS[] = {
+    {&BasicTrainerModel::MODEL, QMetaType::QString},
+    {&BasicTrainerModel::RANDOM_STATE, QMetaType::Int},
+    {&BasicTrainerModel::HIDDEN_LAYER_SIZES, QMetaType::QVector2D},
+};
+constexpr ParameterDescriptor TORCH_TRAINER_PARAMETERS[] = {
+    {&TorchTrainerModel::RANDOM_STATE, QMetaType::Int},
+    {&TorchTrainerModel::MAX_ITER, QMetaType::Int},
+    {&TorchTrainerModel::LEARNING_RATE, QMetaType::Double},
+};
 } // namespace
 
 TrainerModel::TrainerModel(const QString &name, const QString &functionName)
@@ -24,13 +34,13 @@ bool TrainerModel::portNumberModifiable(const PortType &portType) const
     return portType == PortType::In;
 }
 
-uint TrainerModel::minModifiablePorts(const PortType &portType, const QString &typeId) const
+uint TrainerModel::minModifiablePorts(const PortType &portType, PortKind kind) const
 {
     if (portType == PortType::In)
-        if (typeId == constants::DATA_PORT_ID)
+        if (kind == DataPort)
             return 2;
     if (portType == PortType::Out)
-        if (typeId == constants::FUNCTION_PORT_ID)
+        if (kind == FunctionPort)
             return 1;
     return 0;
 }
@@ -124,13 +134,9 @@ std::unordered_map<QString, QString> BasicTrainerModel::getParameters() const
     return result;
 }
 
-std::unordered_map<QString, QMetaType::Type> BasicTrainerModel::getParameterSchema() const
+ParameterSchema BasicTrainerModel::getParameterSchema() const
 {
-    std::unordered_map<QString, QMetaType::Type> schema;
-    schema[RANDOM_STATE] = QMetaType::Int;
-    schema[MODEL] = QMetaType::QString;
-    schema[HIDDEN_LAYER_SIZES] = QMetaType::QVector2D;
-    return schema;
+    return BASIC_TRAINER_PARAMETERS;
 }
 
 QStringList BasicTrainerModel::getParameterOptions(const QString &key) const
@@ -202,13 +208,9 @@ std::unordered_map<QString, QString> TorchTrainerModel::getParameters() const
     return result;
 }
 
-std::unordered_map<QString, QMetaType::Type> TorchTrainerModel::getParameterSchema() const
+ParameterSchema TorchTrainerModel::getParameterSchema() const
 {
-    std::unordered_map<QString, QMetaType::Type> schema;
-    schema[RANDOM_STATE] = QMetaType::Int;
-    schema[MAX_ITER] = QMetaType::Int;
-    schema[LEARNING_RATE] = QMetaType::Double;
-    return schema;
+    return TORCH_TRAINER_PARAMETERS;
 }
 
 void TorchTrainerModel::setParameter(const QString &key, const QString &value)
@@ -1,10 +1,25 @@
 #include "ui/models/uid_manager.hpp"
 #include "data/custom_graph.hpp"
+#include "logging_categories.hpp"
 #include "ui/models/fdf_block_model.hpp"
 #include "ui/models/nodes.hpp"
 #include <QDebug>
+#include <set>
 
-UIDManager::UIDManager() {}
+UIDManager::UIDManager(std::shared_ptr<StringInterner> interner)
+    : m_interner(interner)
+{
+    Atom noneTag = m_interner->intern(NONE_TAG);
+    uidToTag[NONE_ID] = noneTag;
+    tagToUid[noneTag] = NONE_ID;
+}
+
+UIDManager::~UIDManager()
+{
+    // the graph of a tab is deleted later than its manager, its ports must not reach back
+    for (auto port : boundPorts)
+        port->m_uidManager = nullptr;
+}
 
 FdfUID UIDManager::createUID()
 {
@@ -35,14 +50,14 @@ QString UIDManager::getUniqueTag(QString tag)
 {
     int counter = 1;
     QString newTag = QString("%1").arg(tag);
-    while (tagToUid.count(newTag) > 0)
+    while (tagToUid.count(m_interner->find(newTag)) > 0)
         newTag = QString("%1_%2").arg(tag).arg(counter++);
     return newTag;
 }
 
 FdfUID UIDManager::getUid(const QString &tag) const
 {
-    auto elem = tagToUid.find(tag);
+    auto elem = tagToUid.find(m_interner->find(tag));
     if (elem != tagToUid.end())
         return elem->second;
     return NONE_ID;
@@ -52,7 +67,7 @@ QString UIDManager::getTag(const FdfUID &uid) const
 {
     auto elem = uidToTag.find(uid);
     if (elem != uidToTag.end())
-        return elem->second;
+        return m_interner->string(elem->second);
     return NONE_TAG;
 }
 
@@ -61,18 +76,19 @@ void UIDManager::updateMap(FdfUID &uid, QString &tag)
     if (uid == NONE_ID || tag == NONE_TAG)
         return;
     tag.replace(" ", "");
+    Atom tagAtom = m_interner->intern(tag);
     if (uidToTag.find(uid) == uidToTag.end()) {
         // UID is created afresh, triggered from createUid()
-        uidToTag[uid] = tag;
-        tagToUid[tag] = uid;
+        uidToTag[uid] = tagAtom;
+        tagToUid[tagAtom] = uid;
     } else {
-        if (tagToUid.find(tag) == tagToUid.end()) // user changes the type tag on UI for readability
+        if (tagToUid.find(tagAtom) == tagToUid.end()) // user changes the type tag on UI for readability
         {
-            tagToUid.erase(getTag(uid)); // remove the current entry from tagToId
+            tagToUid.erase(uidToTag[uid]); // remove the current entry from tagToId
             // Update both maps
-            tagToUid[tag] = uid;
-            uidToTag[uid] = tag;
-        } else if (uidToTag[uid] == tag) {
+            tagToUid[tagAtom] = uid;
+            uidToTag[uid] = tagAtom;
+        } else if (uidToTag[uid] == tagAtom) {
             // nothing to update, return
             return;
         } else // user chooses to override a type mismatch, setting a type to another existent type
@@ -80,114 +96,139 @@ void UIDManager::updateMap(FdfUID &uid, QString &tag)
             FdfUID removeId = std::max(uid, getUid(tag));
             FdfUID keepId = std::min(uid, getUid(tag));
             // update the graph to replace all instances of removeId with keepId
-            overrideType(removeId, keepId);
-            tagToUid.erase(getTag(removeId));
+            tagToUid.erase(uidToTag.at(removeId));
             uidToTag.erase(removeId);
+            overrideType(removeId, keepId);
+            return;
         }
-        refreshDisplayNames(); // calls updateDisplayName on all DataNodes on a type override
+        refreshDisplayNames(uid);
     }
     // displayMaps();
 }
 
 void UIDManager::displayMaps() const
 {
-    qInfo() << "UID to Tag Map:";
+    qCDebug(lcTyping) << "UID to Tag Map:";
     for (const auto &pair : uidToTag) {
-        qInfo() << "UID:" << pair.first << "-> Tag:" << pair.second;
+        qCDebug(lcTyping) << "UID:" << pair.first << "-> Tag:" << m_interner->string(pair.second);
     }
 
-    qInfo() << "Tag to UID Map:";
+    qCDebug(lcTyping) << "Tag to UID Map:";
     for (const auto &pair : tagToUid) {
-        qInfo() << "Tag:" << pair.first << "-> UID:" << pair.second;
+        qCDebug(lcTyping) << "Tag:" << m_interner->string(pair.first) << "-> UID:" << pair.second;
     }
 }
 
-void UIDManager::refreshDisplayNames()
+void UIDManager::indexPort(NamedNode *port, FdfUID uid, PortRef ref)
 {
-    if (!graph) {
-        qWarning() << "UID Manager does not have an associated graph!";
+    if (uid == NONE_ID)
         return;
-    }
+    portIndex[uid][port].push_back(ref);
+}
 
-    for (const auto &id : graph->allNodeIds()) {
-        auto block = graph->delegateModel<FdfBlockModel>(id);
-        if (!block)
-            continue;
+void UIDManager::unindexPort(NamedNode *port, FdfUID uid)
+{
+    auto entry = portIndex.find(uid);
+    if (entry == portIndex.end())
+        return;
+    entry->second.erase(port);
+    if (entry->second.empty())
+        portIndex.erase(entry);
+}
 
-        for (int i = 0; i < block->nPorts(PortType::Out); i++) {
-            if (auto dataPort = std::dynamic_pointer_cast<DataNode>(block->outData(i))) {
-                QString currentDisplayName = dataPort->name();
-                dataPort->updateDisplayName();
-                if (currentDisplayName != dataPort->name()) {
-                    block->propagateUpdate();
-                }
-                // we need to also ensure output port captions remain unique after tag changes
-                // since captions are now deterministic
-                graph->makeOutPortsUnique(id, block, i);
-            }
-        }
+size_t UIDManager::referenceCount(FdfUID uid) const
+{
+    auto entry = portIndex.find(uid);
+    return entry == portIndex.end() ? 0 : entry->second.size();
+}
+
+void UIDManager::refreshDisplayNames(FdfUID uid)
+{
+    lastVisited = 0;
+    auto entry = portIndex.find(uid);
+    if (entry == portIndex.end())
+        return;
+    std::vector<NamedNode *> renamed;
+    lastVisited = entry->second.size();
+    for (auto &[port, refs] : entry->second) {
+        if (refs.front().role != PortRef::Data)
+            continue;
+        auto dataPort = static_cast<DataNode *>(port);
+        QString currentDisplayName = dataPort->name();
+        dataPort->updateDisplayName();
+        if (currentDisplayName != dataPort->name())
+            renamed.push_back(port);
     }
+    updateOwners(renamed, {});
 }
 
 void UIDManager::overrideType(FdfUID removeType, FdfUID keepType)
 {
-    if (!graph) {
-        qWarning() << "UID Manager does not have an associated graph!";
+    lastVisited = 0;
+    auto entry = portIndex.find(removeType);
+    if (entry == portIndex.end())
         return;
-    }
-    // Step 1: Update types in the graph
-    for (const auto &id : graph->allNodeIds()) {
-        auto block = graph->delegateModel<FdfBlockModel>(id);
-        if (!block)
+    lastVisited = entry->second.size();
+    // the ports register themselves under keepType while being updated
+    auto references = std::move(entry->second);
+    portIndex.erase(entry);
+
+    std::vector<NamedNode *> renamed;
+    std::vector<NamedNode *> retyped;
+    for (auto &[port, refs] : references) {
+        if (refs.front().role == PortRef::Data) {
+            auto dataPort = static_cast<DataNode *>(port);
+            QString currentDisplayName = dataPort->name();
+            dataPort->setTypeId(keepType);
+            if (currentDisplayName != dataPort->name())
+                renamed.push_back(port);
+            else
+                retyped.push_back(port);
             continue;
-
-        bool updated = false;
-
-        for (int i = 0; i < block->nPorts(PortType::Out); i++) {
-            auto dataPort = std::dynamic_pointer_cast<DataNode>(block->outData(i));
-            if (dataPort && dataPort->typeId() == removeType) {
-                dataPort->setTypeId(keepType);
-                updated = true;
-                continue;
-            }
-
-            auto functionPort = std::dynamic_pointer_cast<FunctionNode>(block->outData(i));
-            if (!functionPort)
-                continue;
-
-            Signature signature = functionPort->signature();
-
-            // Replace type in input and output signatures
-            updated = replaceTypesInUIDVector(signature.inputs, keepType, removeType);
-            updated = replaceTypesInUIDVector(signature.outputs, keepType, removeType);
-
-            if (updated)
-                functionPort->setSignature(signature);
         }
-
-        if (updated)
-            block->propagateUpdate();
+        auto functionPort = static_cast<FunctionNode *>(port);
+        Signature signature = functionPort->signature();
+        for (const auto &ref : refs) {
+            auto &types = ref.role == PortRef::SignatureInput ? signature.inputs
+                                                              : signature.outputs;
+            types.at(ref.position) = keepType;
+        }
+        functionPort->setSignature(signature);
+        retyped.push_back(port);
     }
+    updateOwners(renamed, retyped);
 }
 
-bool UIDManager::replaceTypesInUIDVector(std::vector<FdfUID> &vec,
-                                         FdfUID keepType,
-                                         FdfUID removeType)
+void UIDManager::updateOwners(const std::vector<NamedNode *> &renamed,
+                              const std::vector<NamedNode *> &retyped)
 {
-    bool updated = false;
-    for (FdfUID &item : vec)
-        if (item == removeType) {
-            item = keepType;
-            updated = true;
-        }
-    return updated;
+    // ports of a manager without graph (e.g. the fallback one) only update their names
+    if (!graph || (renamed.empty() && retyped.empty()))
+        return;
+    CustomGraph::Batch batch(*graph);
+    std::set<NodeId> updatedBlocks;
+    for (auto port : renamed) {
+        auto block = graph->delegateModel<FdfBlockModel>(port->ownerId());
+        if (!block)
+            continue;
+        // captions are deterministic, so they must be made unique again after a tag change
+        auto index = block->outPortIndex(port);
+        if (index != QtNodes::InvalidPortIndex)
+            graph->makeOutPortsUnique(port->ownerId(), block, index);
+        updatedBlocks.insert(port->ownerId());
+    }
+    for (auto port : retyped)
+        updatedBlocks.insert(port->ownerId());
+    for (const auto &id : updatedBlocks)
+        if (auto block = graph->delegateModel<FdfBlockModel>(id))
+            block->propagateUpdate();
 }
 
 ConnectionInfo UIDManager::getConnectionInfo(QtNodes::ConnectionId const connectionId) const
 {
     ConnectionInfo connInfo;
     if (!graph) {
-        qWarning() << "UID Manager does not have an associated graph!";
+        qCWarning(lcTyping) << "UID Manager does not have an associated graph!";
         return connInfo;
     }
     connInfo.inNodeId = getNodeId(PortType::In, connectionId);
@@ -202,14 +243,11 @@ ConnectionInfo UIDManager::getConnectionInfo(QtNodes::ConnectionId const connect
             connInfo.outIndex = getPortIndex(PortType::Out, connectionId);
             connInfo.inIndex = getPortIndex(PortType::In, connectionId);
             // Fetch the incoming type
-            if (auto data = std::dynamic_pointer_cast<DataNode>(
-                    outBlock->outData(connInfo.outIndex)))
+            if (auto data = outBlock->outPort<DataNode>(connInfo.outIndex)) {
                 connInfo.receivedOutType = data->typeId();
-            else if (auto function = std::dynamic_pointer_cast<FunctionNode>(
-                         outBlock->outData(connInfo.outIndex))) {
-                std::shared_ptr<Signature> receivedSig = std::make_shared<Signature>(
-                    function->signature());
-                connInfo.receivedSignature = receivedSig;
+                connInfo.receivedChunked = data->isChunked();
+            } else if (auto function = outBlock->outPort<FunctionNode>(connInfo.outIndex)) {
+                connInfo.receivedSignature = &function->signature();
             }
         }
     return connInfo;
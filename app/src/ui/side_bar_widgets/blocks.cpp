@@ -28,6 +28,8 @@
 #include "data/block_manager.hpp"
 #include "data/constants.hpp"
 #include "data/tab_manager.hpp"
+#include "logging_categories.hpp"
+#include "ui/models/composite_model.hpp"
 #include "ui/models/fdf_block_model.hpp"
 #include "ui/models/function_names.hpp"
 #include "ui/models/trainer_models.hpp"
@@ -103,13 +105,11 @@ void Blocks::updateFields()
         m_functionNameEdit->setText(block->functionName());
         QString sanitizedCaption = constants::sanitizeCaption(block->caption());
         m_captionEdit->setText(sanitizedCaption);
-        m_inputPortEdit->setMinimum(
-            block->minModifiablePorts(PortType::In, constants::DATA_PORT_ID));
-        m_inputPortEdit->setValue(block->nPorts(PortType::In, constants::DATA_PORT_ID));
+        m_inputPortEdit->setMinimum(block->minModifiablePorts(PortType::In, DataPort));
+        m_inputPortEdit->setValue(block->nPorts(PortType::In, DataPort));
         m_inputPortEdit->setEnabled(block->portNumberModifiable(PortType::In));
-        m_outputPortEdit->setMinimum(
-            block->minModifiablePorts(PortType::Out, constants::DATA_PORT_ID));
-        m_outputPortEdit->setValue(block->nPorts(PortType::Out, constants::DATA_PORT_ID));
+        m_outputPortEdit->setMinimum(block->minModifiablePorts(PortType::Out, DataPort));
+        m_outputPortEdit->setValue(block->nPorts(PortType::Out, DataPort));
         m_outputPortEdit->setEnabled(block->portNumberModifiable(PortType::Out));
 
         if (auto parameterWidget = generateParameterWidget(block))
@@ -312,6 +312,9 @@ void Blocks::initLibrary()
         item->setFlags(item->flags() & ~Qt::ItemIsSelectable);
     }
     for (auto const &assoc : registry->registeredModelsCategoryAssociation()) {
+        // boundary blocks are created when grouping, they are registered only to be loaded
+        if (assoc.first == composite_names::INPUT || assoc.first == composite_names::OUTPUT)
+            continue;
         QList<QTreeWidgetItem *> parent = treeView->findItems(assoc.second, Qt::MatchExactly);
         if (parent.count() <= 0)
             continue;
@@ -370,7 +373,7 @@ QWidget *Blocks::generatePortsWidget(FdfBlockModel *block)
 
     auto uidManager = m_tabManager->getCurrentUIDManager();
     if (!uidManager) {
-        qWarning() << "UIDManager is null!";
+        qCWarning(lcUi) << "UIDManager is null!";
         return nullptr;
     }
 
@@ -385,6 +388,8 @@ QWidget *Blocks::generatePortsWidget(FdfBlockModel *block)
      | Port ID | Caption |
      else if both data and function nodes are present,
      | Port ID | Type Tag | Annotation | Caption |
+     the persistence column is appended at the end, except for data sources and outputs
+     which the catalog does not declare from their ports.
     */
 
     QVector<int> visibleCols = {constants::PortTableColIndex::COL_PORT_ID};
@@ -398,6 +403,11 @@ QWidget *Blocks::generatePortsWidget(FdfBlockModel *block)
         visibleCols << constants::PortTableColIndex::COL_CAPTION;
         headers << "Caption";
     }
+    if (block->type() != FdfBlockModel::FdfType::Data
+        && block->type() != FdfBlockModel::FdfType::Output) {
+        visibleCols << constants::PortTableColIndex::COL_PERSISTENCE;
+        headers << "Persistence";
+    }
 
     auto tableWidget = new QTableWidget(portCount,
                                         visibleCols.size()); // Number of columns of side table
@@ -410,9 +420,8 @@ QWidget *Blocks::generatePortsWidget(FdfBlockModel *block)
 
     for (int i = 0; i < portCount; ++i) {
         int colIndex = 0;
-        auto outData = block->outData(i);
-        auto dataNode = std::dynamic_pointer_cast<DataNode>(outData);
-        auto funcNode = std::dynamic_pointer_cast<FunctionNode>(outData);
+        auto dataNode = block->outPort<DataNode>(i);
+        auto funcNode = block->outPort<FunctionNode>(i);
 
         for (int col : visibleCols) {
             QTableWidgetItem *item = nullptr;
@@ -464,6 +473,23 @@ QWidget *Blocks::generatePortsWidget(FdfBlockModel *block)
                     item->setFlags(Qt::NoItemFlags);
                 }
                 break;
+
+            case constants::PortTableColIndex::COL_PERSISTENCE:
+                if (auto namedNode = block->outPort<NamedNode>(i)) {
+                    auto comboBox = new QComboBox;
+                    comboBox->addItems(namedNode->persistenceOptions());
+                    comboBox->setCurrentText(namedNode->persistenceString());
+                    comboBox->setToolTip("How kedro hands this output to the connected blocks");
+                    connect(comboBox,
+                            &QComboBox::currentTextChanged,
+                            block,
+                            [block, namedNode](const QString &text) {
+                                namedNode->setPersistence(text);
+                                emit block->contentUpdated();
+                            });
+                    tableWidget->setCellWidget(i, colIndex, comboBox);
+                }
+                break;
             }
 
             if (item)
@@ -495,8 +521,8 @@ void Blocks::handlePortEdit(FdfBlockModel *block,
     // get the correct column index as the number of columns changes dynamically
     int col = visibleCols.value(tableCol, -1);
     int row = item->row();
-    auto dataNode = std::dynamic_pointer_cast<DataNode>(block->outData(row));
-    auto funcNode = std::dynamic_pointer_cast<FunctionNode>(block->outData(row));
+    auto dataNode = block->outPort<DataNode>(row);
+    auto funcNode = block->outPort<FunctionNode>(row);
 
     auto checkTypeTagConflict = []() -> bool {
         auto box = QMessageBox::question(nullptr,
@@ -540,19 +566,19 @@ QWidget *Blocks::generateParameterWidget(FdfBlockModel *block)
     auto widget = new QWidget;
     auto layout = new QFormLayout(widget);
     layout->setContentsMargins(0, 0, 0, 0);
-    for (auto &pair : block->getParameterSchema()) {
-        auto key = pair.first;
+    for (const auto &parameter : block->getParameterSchema()) {
+        auto key = *parameter.key;
         // value is not found for now, we need to decide how to add optional params
         if (values.count(key) < 1)
             continue;
         auto value = values.at(key);
-        if (pair.second == QMetaType::QString) {
+        if (parameter.type == QMetaType::QString) {
             auto options = block->getParameterOptions(key);
             if (options.isEmpty()) {
                 auto edit = new QLineEdit(value);
                 layout->addRow(new QLabel(key), edit);
                 connect(edit, &QLineEdit::textChanged, block, [block, key](const QString &text) {
-                    block->setParameter(key, text);
+                    block->updateParameter(key, text);
                 });
             } else {
                 auto comboBox = new QComboBox;
@@ -562,9 +588,9 @@ QWidget *Blocks::generateParameterWidget(FdfBlockModel *block)
                 connect(comboBox,
                         &QComboBox::currentTextChanged,
                         block,
-                        [block, key](const QString &text) { block->setParameter(key, text); });
+                        [block, key](const QString &text) { block->updateParameter(key, text); });
             }
-        } else if (pair.second == QMetaType::Int) {
+        } else if (parameter.type == QMetaType::Int) {
             auto spin = new QSpinBox;
             spin->setRange(std::numeric_limits<int>::lowest(), std::numeric_limits<int>::max());
             spin->setMaximumWidth(constants::INT_SPIN_BOX_MAX_WIDTH);
@@ -572,9 +598,9 @@ QWidget *Blocks::generateParameterWidget(FdfBlockModel *block)
             spin->setValue(value.toInt());
             layout->addRow(new QLabel(key), spin);
             connect(spin, &QSpinBox::valueChanged, block, [block, key](const int &value) {
-                block->setParameter(key, QString::number(value));
+                block->updateParameter(key, QString::number(value));
             });
-        } else if (pair.second == QMetaType::Double) {
+        } else if (parameter.type == QMetaType::Double) {
             auto spin = new QDoubleSpinBox;
             spin->setRange(0, std::numeric_limits<double>::max());
             spin->setDecimals(4);
@@ -583,9 +609,9 @@ QWidget *Blocks::generateParameterWidget(FdfBlockModel *block)
             spin->setValue(value.toDouble());
             layout->addRow(new QLabel(key), spin);
             connect(spin, &QDoubleSpinBox::valueChanged, block, [block, key](double value) {
-                block->setParameter(key, QString::number(value, 'f', 6));
+                block->updateParameter(key, QString::number(value, 'f', 6));
             });
-        } else if (pair.second == QMetaType::QPoint) {
+        } else if (parameter.type == QMetaType::QPoint) {
             auto pointLayout = new QHBoxLayout();
             {
                 int xValue = value.mid(value.indexOf('[') + 1, value.indexOf(',') - 1).toInt();
@@ -606,27 +632,27 @@ QWidget *Blocks::generateParameterWidget(FdfBlockModel *block)
                 ySpin->setValue(yValue);
                 pointLayout->addWidget(ySpin);
                 connect(xSpin, &QSpinBox::valueChanged, block, [block, key, ySpin](const int &value) {
-                    block->setParameter(key,
-                                        QString("[%1, %2]")
-                                            .arg(QString::number(value),
-                                                 QString::number(ySpin->value())));
+                    block->updateParameter(key,
+                                           QString("[%1, %2]")
+                                               .arg(QString::number(value),
+                                                    QString::number(ySpin->value())));
                 });
                 connect(ySpin, &QSpinBox::valueChanged, block, [block, key, xSpin](const int &value) {
-                    block->setParameter(key,
-                                        QString("[%1, %2]")
-                                            .arg(QString::number(xSpin->value()), value));
+                    block->updateParameter(key,
+                                           QString("[%1, %2]")
+                                               .arg(QString::number(xSpin->value()), value));
                 });
             }
             layout->addRow(new QLabel(key), pointLayout);
-        } else if (pair.second == QMetaType::QVector2D) {
+        } else if (parameter.type == QMetaType::QVector2D) {
             // UI for this can be improved
             auto edit = new QLineEdit(value);
             layout->addRow(new QLabel(key), edit);
             connect(edit, &QLineEdit::textChanged, block, [block, key](const QString &text) {
-                block->setParameter(key, text);
+                block->updateParameter(key, text);
             });
         } else {
-            qCritical() << "Block parameter type is unhandled" << pair.second;
+            qCCritical(lcUi) << "Block parameter type is unhandled" << parameter.type;
         }
     }
     return widget;
@@ -9,6 +9,7 @@
 #include <QVBoxLayout>
 
 #include "data/settings.hpp"
+#include "logging_categories.hpp"
 
 namespace {
 
@@ -17,6 +18,15 @@ QVariant settingValue(const QString &key)
     return data::Settings::instance().value(key);
 }
 
+void checkSubsystems(const QList<QCheckBox *> &boxes, const QStringList &enabled)
+{
+    for (auto box : boxes) {
+        box->blockSignals(true);
+        box->setChecked(enabled.contains(box->objectName()));
+        box->blockSignals(false);
+    }
+}
+
 } // namespace
 
 Settings::Settings(MainWindow *mw, QWidget *parent)
@@ -24,6 +34,7 @@ Settings::Settings(MainWindow *mw, QWidget *parent)
     , m_formatBox(new QComboBox)
     , m_engineBox(new QComboBox)
     , m_engineTimeoutBox(new QSpinBox)
+    , m_openGlBox(new QCheckBox("OpenGL viewport (new tabs)"))
     , mainWindowPtr(mw)
 {
     auto scrollArea = new QScrollArea;
@@ -57,10 +68,24 @@ Settings::Settings(MainWindow *mw, QWidget *parent)
         layout->addWidget(gridEnable);
         connect(gridEnable, &QCheckBox::toggled, mainWindowPtr, &MainWindow::gridToggled);
 
+        layout->addWidget(m_openGlBox);
+
+#ifndef QT_NO_DEBUG_OUTPUT
+        layout->addWidget(new QLabel("Debug output: "));
+        for (const auto &subsystem : logging::subsystems()) {
+            auto box = new QCheckBox(subsystem);
+            box->setObjectName(subsystem);
+            layout->addWidget(box);
+            m_debugLogBoxes.append(box);
+        }
+#endif
+
         { // set default values to the UI
             m_formatBox->setCurrentText(settingValue("default export format").toString());
             m_engineBox->setCurrentText(settingValue("engine").toString());
             m_engineTimeoutBox->setValue(settingValue("engine timeout (minutes)").toInt());
+            m_openGlBox->setChecked(settingValue("opengl viewport").toBool());
+            checkSubsystems(m_debugLogBoxes, settingValue("debug log subsystems").toStringList());
         }
 
         auto &s = data::Settings::instance();
@@ -74,6 +99,17 @@ Settings::Settings(MainWindow *mw, QWidget *parent)
             connect(m_engineTimeoutBox, &QSpinBox::valueChanged, &s, [&s](const int &value) {
                 s.setValue("engine timeout (minutes)", value);
             });
+            connect(m_openGlBox, &QCheckBox::toggled, &s, [&s](bool value) {
+                s.setValue("opengl viewport", value);
+            });
+            for (auto box : m_debugLogBoxes)
+                connect(box, &QCheckBox::toggled, &s, [this, &s]() {
+                    QStringList enabled;
+                    for (auto box : m_debugLogBoxes)
+                        if (box->isChecked())
+                            enabled << box->objectName();
+                    s.setValue("debug log subsystems", enabled);
+                });
         }
 
         // connects for updating setting changes
@@ -97,7 +133,13 @@ void Settings::onSettingUpdated(const QString &key, const QVariant &value)
         m_engineTimeoutBox->blockSignals(true);
         m_engineTimeoutBox->setValue(value.toInt());
         m_engineTimeoutBox->blockSignals(false);
+    } else if (key == "opengl viewport") {
+        m_openGlBox->blockSignals(true);
+        m_openGlBox->setChecked(value.toBool());
+        m_openGlBox->blockSignals(false);
+    } else if (key == "debug log subsystems") {
+        checkSubsystems(m_debugLogBoxes, value.toStringList());
     } else {
-        qCritical() << "Setting update key not handled: " << key;
+        qCCritical(lcUi) << "Setting update key not handled: " << key;
     }
 }
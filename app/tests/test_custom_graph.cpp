@@ -0,0 +1,285 @@
+#include "data/block_manager.hpp"
+#include "data/custom_graph.hpp"
+#include "data/graph_snapshot.hpp"
+#include "ui/models/composite_model.hpp"
+#include "ui/models/fdf_block_model.hpp"
+#include "ui/models/io_models.hpp"
+#include <gtest/gtest.h>
+#include <QJsonArray>
+#include <QSet>
+#include <QSignalSpy>
+
+#include <QtNodes/DagGraphicsScene>
+
+TEST(CustomGraphTest, BatchDefersUniqueCaptionsUntilCommit)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    QSignalSpy committed(&graph, &CustomGraph::batchCommitted);
+    std::vector<QtNodes::NodeId> ids;
+    {
+        CustomGraph::Batch batch(graph);
+        for (int i = 0; i < 3; ++i)
+            ids.push_back(graph.addNode(io_names::DATA_SOURCE));
+        EXPECT_TRUE(graph.inBatch());
+        EXPECT_EQ(graph.delegateModel<FdfBlockModel>(ids.back())->caption(),
+                  graph.delegateModel<FdfBlockModel>(ids.front())->caption());
+        EXPECT_EQ(committed.count(), 0);
+    }
+    EXPECT_FALSE(graph.inBatch());
+    EXPECT_EQ(committed.count(), 1);
+
+    QSet<QString> captions;
+    for (const auto &id : ids)
+        captions.insert(graph.delegateModel<FdfBlockModel>(id)->caption());
+    EXPECT_EQ(captions.size(), 3);
+    // the first node keeps its caption
+    EXPECT_EQ(graph.delegateModel<FdfBlockModel>(ids.front())->caption(), io_names::DATA_SOURCE);
+}
+
+TEST(CustomGraphTest, NestedBatchCommitsOnce)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    QSignalSpy committed(&graph, &CustomGraph::batchCommitted);
+    {
+        CustomGraph::Batch outer(graph);
+        {
+            CustomGraph::Batch inner(graph);
+            graph.addNode(io_names::DATA_SOURCE);
+        }
+        EXPECT_TRUE(graph.inBatch());
+        EXPECT_EQ(committed.count(), 0);
+    }
+    EXPECT_EQ(committed.count(), 1);
+}
+
+TEST(CustomGraphTest, BatchCreatesSceneItemsOnCommit)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    QtNodes::DagGraphicsScene scene(graph);
+    graph.attachScene(&scene);
+    QtNodes::NodeId source;
+    QtNodes::ConnectionId connectionId;
+    {
+        CustomGraph::Batch batch(graph);
+        source = graph.addNode(io_names::DATA_SOURCE);
+        auto output = graph.addNode(io_names::DATA_OUT);
+        connectionId = {source, 0, output, 0};
+        graph.addConnection(connectionId);
+        auto removed = graph.addNode(io_names::DATA_SOURCE);
+        graph.deleteNode(removed);
+        EXPECT_EQ(scene.nodeGraphicsObject(source), nullptr);
+        EXPECT_EQ(scene.connectionGraphicsObject(connectionId), nullptr);
+    }
+    EXPECT_NE(scene.nodeGraphicsObject(source), nullptr);
+    EXPECT_NE(scene.connectionGraphicsObject(connectionId), nullptr);
+
+    // outside a batch, or in one that keeps the scene, the items are created right away
+    EXPECT_NE(scene.nodeGraphicsObject(graph.addNode(io_names::DATA_SOURCE)), nullptr);
+    CustomGraph::Batch batch(graph, CustomGraph::Batch::KeepScene);
+    EXPECT_NE(scene.nodeGraphicsObject(graph.addNode(io_names::DATA_SOURCE)), nullptr);
+}
+
+TEST(CustomGraphTest, BatchReportsUpdatedNodesOnce)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    QSignalSpy updated(&graph, &CustomGraph::nodeUpdated);
+    QtNodes::NodeId id;
+    {
+        CustomGraph::Batch batch(graph);
+        id = graph.addNode(io_names::DATA_SOURCE);
+        auto source = graph.delegateModel<DataSourceModel>(id);
+        source->setFile(QFileInfo("first.csv"));
+        source->setFile(QFileInfo("second.csv"));
+        EXPECT_EQ(updated.count(), 0);
+    }
+    int count = 0;
+    for (const auto &arguments : updated)
+        if (arguments.at(0).value<QtNodes::NodeId>() == id)
+            ++count;
+    EXPECT_EQ(count, 1);
+}
+
+TEST(CustomGraphTest, UniqueCaptionsWithManySimilarNames)
+{
+    const int NODES = 1000;
+    CustomGraph graph(BlockManager::getRegistry());
+    std::vector<QtNodes::NodeId> ids;
+    {
+        CustomGraph::Batch batch(graph);
+        for (int i = 0; i < NODES; ++i)
+            ids.push_back(graph.addNode(io_names::DATA_SOURCE));
+    }
+    for (int i = 0; i < NODES; ++i)
+        ids.push_back(graph.addNode(io_names::DATA_SOURCE));
+
+    QSet<QString> captions;
+    for (const auto &id : ids)
+        captions.insert(graph.delegateModel<FdfBlockModel>(id)->caption());
+    EXPECT_EQ(captions.size(), ids.size());
+    const auto last = ids.size();
+    EXPECT_NE(graph.getBlockByCaption(QString("%1_%2").arg(io_names::DATA_SOURCE).arg(last)),
+              nullptr);
+    // a deleted caption is released, the suffix counter does not go back
+    auto deleted = graph.delegateModel<FdfBlockModel>(ids.at(1))->caption();
+    graph.deleteNode(ids.at(1));
+    EXPECT_EQ(graph.getBlockByCaption(deleted), nullptr);
+    auto id = graph.addNode(io_names::DATA_SOURCE);
+    EXPECT_EQ(graph.delegateModel<FdfBlockModel>(id)->caption(),
+              QString("%1_%2").arg(io_names::DATA_SOURCE).arg(last + 1));
+}
+
+TEST(CustomGraphTest, ValidityFollowsGraphChanges)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    EXPECT_TRUE(graph.allBlocksValid());
+    auto first = graph.addNode(io_names::DATA_SOURCE);
+    auto second = graph.addNode(io_names::DATA_SOURCE);
+    EXPECT_EQ(graph.componentCount(), 2);
+
+    // data sources without a file cannot run
+    EXPECT_FALSE(graph.allBlocksValid());
+    auto issues = graph.validityIssues();
+    EXPECT_EQ(issues.size(), 2);
+    EXPECT_EQ(issues.count(first), 1);
+
+    graph.deleteNode(second);
+    EXPECT_EQ(graph.componentCount(), 1);
+    EXPECT_EQ(graph.validityIssues().count(second), 0);
+}
+
+TEST(CustomGraphTest, LoadDropsConnectionsBetweenPortKinds)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    auto source = graph.addNode(io_names::DATA_SOURCE);
+    auto funcOut = graph.addNode(io_names::FUNC_OUT);
+    auto json = graph.save();
+    // a hand edited file wiring data into a function port
+    QJsonArray connections;
+    connections.append(QJsonObject{{"outNodeId", static_cast<qint64>(source)},
+                                   {"outPortIndex", 0},
+                                   {"inNodeId", static_cast<qint64>(funcOut)},
+                                   {"inPortIndex", 0}});
+    json["connections"] = connections;
+
+    CustomGraph loaded(BlockManager::getRegistry());
+    loaded.load(json);
+    ASSERT_TRUE(loaded.nodeExists(funcOut));
+    EXPECT_TRUE(loaded.allConnectionIds(funcOut).empty());
+    EXPECT_TRUE(loaded.delegateModel<FdfBlockModel>(funcOut)->portData(PortType::In, 0) == nullptr);
+}
+
+TEST(CustomGraphTest, ParameterEditsRecheckValidity)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    auto id = graph.addNode(io_names::DATA_SOURCE);
+    auto source = graph.delegateModel<DataSourceModel>(id);
+    source->setFile(QFileInfo("data.mat"));
+    EXPECT_TRUE(graph.allBlocksValid());
+
+    source->updateParameter(DataSourceModel::ROWS, "not a range");
+    EXPECT_FALSE(graph.allBlocksValid());
+    EXPECT_EQ(graph.validityIssues().count(id), 1);
+
+    source->updateParameter(DataSourceModel::ROWS, "");
+    EXPECT_TRUE(graph.allBlocksValid());
+}
+
+TEST(CustomGraphTest, DiamondPropagatesEachBlockOnce)
+{
+    // top feeds left and right, which both feed bottom
+    CustomGraph graph(BlockManager::getRegistry());
+    auto top = graph.addNode("difference");
+    auto left = graph.addNode("difference");
+    auto right = graph.addNode("difference");
+    auto bottom = graph.addNode("difference");
+    graph.addConnection({top, 0, left, 0});
+    graph.addConnection({top, 0, right, 0});
+    graph.addConnection({left, 0, bottom, 0});
+    graph.addConnection({right, 0, bottom, 1});
+
+    std::vector<std::unique_ptr<QSignalSpy>> spies;
+    for (const auto &id : {top, left, right, bottom})
+        spies.push_back(std::make_unique<QSignalSpy>(graph.delegateModel<FdfBlockModel>(id),
+                                                     &FdfBlockModel::dataUpdated));
+    graph.delegateModel<FdfBlockModel>(top)->propagateUpdate();
+    for (const auto &spy : spies)
+        EXPECT_EQ(spy->count(), 1);
+}
+
+TEST(CustomGraphTest, SnapshotsShareUnchangedNodes)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    auto first = graph.addNode(io_names::DATA_SOURCE);
+    auto second = graph.addNode(io_names::DATA_SOURCE);
+    auto before = graph.snapshot();
+    EXPECT_EQ(before->nodes.size(), 2);
+    // nothing changed, the same snapshot is handed out
+    EXPECT_EQ(graph.snapshot(), before);
+
+    graph.delegateModel<FdfBlockModel>(second)->setCaption("renamed");
+    auto after = graph.snapshot();
+    EXPECT_NE(after, before);
+    EXPECT_GT(after->version, before->version);
+    EXPECT_EQ(after->nodes.at(first), before->nodes.at(first));
+    EXPECT_EQ(after->node(second)->caption, "renamed");
+    // the previous snapshot is left as it was
+    EXPECT_NE(before->node(second)->caption, "renamed");
+
+    graph.deleteNode(first);
+    EXPECT_EQ(graph.snapshot()->node(first), nullptr);
+}
+
+TEST(CustomGraphTest, SnapshotKeepsParameterInputWithoutValues)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    auto split = graph.addNode("split_data");
+    // nothing set yet, the split still takes its params input
+    auto node = graph.snapshot()->node(split);
+    ASSERT_NE(node, nullptr);
+    EXPECT_TRUE(node->parameters.empty());
+    EXPECT_TRUE(node->hasParameters);
+}
+
+TEST(CustomGraphTest, CompositeKeepsGroupedBlocks)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    auto first = graph.addNode("transform");
+    auto second = graph.addNode("transform");
+    auto compositeId = graph.groupIntoComposite({first, second});
+    ASSERT_NE(compositeId, QtNodes::InvalidNodeId);
+    EXPECT_FALSE(graph.nodeExists(first));
+    EXPECT_EQ(graph.allNodeIds().size(), 1);
+
+    auto composite = graph.delegateModel<CompositeModel>(compositeId);
+    ASSERT_NE(composite, nullptr);
+    // the blocks are only built again when the composite is edited
+    EXPECT_FALSE(composite->isExpanded());
+    auto fingerprint = composite->fingerprint();
+
+    // the snapshot is taken from a graph with its own uid manager
+    auto boundPorts = graph.uidManager()->boundPortCount();
+    auto snapshot = composite->pipelineSnapshot();
+    EXPECT_EQ(snapshot->nodes.size(), 2);
+    EXPECT_EQ(graph.uidManager()->boundPortCount(), boundPorts);
+    EXPECT_EQ(composite->pipelineSnapshot(), snapshot);
+    EXPECT_EQ(graph.snapshot()->node(compositeId)->fingerprint, fingerprint);
+
+    // an edited sub-graph shares the types of the graph holding it
+    auto subGraph = composite->expand();
+    ASSERT_NE(subGraph, nullptr);
+    EXPECT_EQ(subGraph->allNodeIds().size(), 2);
+    EXPECT_EQ(subGraph->uidManager(), graph.uidManager());
+    EXPECT_EQ(composite->expand(), subGraph);
+    composite->collapse();
+    EXPECT_FALSE(composite->isExpanded());
+}
+
+TEST(CustomGraphTest, CompositeRefusesDataBlocks)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    auto source = graph.addNode(io_names::DATA_SOURCE);
+    auto transform = graph.addNode("transform");
+    EXPECT_EQ(graph.groupIntoComposite({source, transform}), QtNodes::InvalidNodeId);
+    EXPECT_TRUE(graph.nodeExists(source));
+    EXPECT_EQ(graph.allNodeIds().size(), 2);
+}
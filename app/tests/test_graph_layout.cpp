@@ -0,0 +1,76 @@
+#include "data/graph_layout.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <QRectF>
+
+using data::LayeredLayout;
+using data::LayoutGraph;
+
+TEST(GraphLayoutTest, BlocksFollowTheirInputs)
+{
+    // 0 -> 1 -> 2, 0 -> 2, 3 alone
+    LayoutGraph graph;
+    graph.nodes = {0, 1, 2, 3};
+    graph.edges = {{0, 1}, {1, 2}, {0, 2}};
+    for (const auto &id : graph.nodes)
+        graph.sizes.emplace(id, QSizeF(100, 50));
+    auto positions = LayeredLayout::compute(graph);
+    ASSERT_EQ(positions.size(), 4);
+    EXPECT_LT(positions.at(0).x(), positions.at(1).x());
+    EXPECT_LT(positions.at(1).x(), positions.at(2).x());
+    // sources share the first layer without overlapping
+    EXPECT_EQ(positions.at(3).x(), positions.at(0).x());
+    EXPECT_GE(std::abs(positions.at(3).y() - positions.at(0).y()), 50);
+}
+
+TEST(GraphLayoutTest, SweepsRemoveCrossings)
+{
+    // 0 -> 3 and 1 -> 2 cross when the second layer keeps its insertion order
+    LayoutGraph graph;
+    graph.nodes = {0, 1, 2, 3};
+    graph.edges = {{0, 3}, {1, 2}};
+    auto positions = LayeredLayout::compute(graph);
+    EXPECT_EQ(positions.at(0).y() < positions.at(1).y(),
+              positions.at(3).y() < positions.at(2).y());
+}
+
+TEST(GraphLayoutTest, LargeGraphsKeepLayersApart)
+{
+    const int NODES = 10000;
+    LayoutGraph graph;
+    for (int i = 0; i < NODES; ++i) {
+        graph.nodes.push_back(i);
+        graph.sizes.emplace(i, QSizeF(120, 60));
+        // a few inputs each from earlier blocks
+        if (i > 0)
+            graph.edges.emplace_back(i / 2, i);
+        if (i > 10)
+            graph.edges.emplace_back(i - 10, i);
+    }
+    auto positions = LayeredLayout::compute(graph);
+    ASSERT_EQ(positions.size(), NODES);
+
+    auto rect = [&](QtNodes::NodeId id) { return QRectF(positions.at(id), graph.sizes.at(id)); };
+    // every connection flows left to right
+    for (const auto &edge : graph.edges)
+        EXPECT_LE(rect(edge.first).right(), rect(edge.second).left());
+
+    // blocks of a layer share their left edge, they must not overlap within the layer and
+    // each layer has to end before the next one starts
+    std::map<double, std::vector<QRectF>> layers;
+    for (const auto &id : graph.nodes)
+        layers[positions.at(id).x()].push_back(rect(id));
+    double previousRight = -std::numeric_limits<double>::infinity();
+    for (auto &[left, blocks] : layers) {
+        EXPECT_LT(previousRight, left);
+        std::sort(blocks.begin(), blocks.end(), [](const QRectF &a, const QRectF &b) {
+            return a.top() < b.top();
+        });
+        for (size_t i = 1; i < blocks.size(); ++i)
+            EXPECT_LE(blocks.at(i - 1).bottom(), blocks.at(i).top());
+        for (const auto &block : blocks)
+            previousRight = std::max(previousRight, block.right());
+    }
+}
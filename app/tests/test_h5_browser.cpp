@@ -0,0 +1,75 @@
+#include "data/h5_browser.hpp"
+#include "ui/models/io_models.hpp"
+#include <gtest/gtest.h>
+#include <QFileInfo>
+
+using data::H5Browser;
+using data::H5DatasetInfo;
+
+TEST(H5BrowserTest, ParsesClosedAndOpenRanges)
+{
+    auto closed = H5Browser::parseRange("100:200");
+    ASSERT_TRUE(closed.has_value());
+    EXPECT_EQ(closed->first, 100u);
+    EXPECT_EQ(closed->second, 200u);
+
+    auto open = H5Browser::parseRange(" 5 : ");
+    ASSERT_TRUE(open.has_value());
+    EXPECT_EQ(open->first, 5u);
+    EXPECT_FALSE(open->second.has_value());
+
+    auto fromStart = H5Browser::parseRange(":10");
+    ASSERT_TRUE(fromStart.has_value());
+    EXPECT_EQ(fromStart->first, 0u);
+    EXPECT_EQ(fromStart->second, 10u);
+}
+
+TEST(H5BrowserTest, RejectsMalformedRanges)
+{
+    EXPECT_FALSE(H5Browser::parseRange("").has_value());
+    EXPECT_FALSE(H5Browser::parseRange("10").has_value());
+    EXPECT_FALSE(H5Browser::parseRange("a:b").has_value());
+    EXPECT_FALSE(H5Browser::parseRange("20:10").has_value());
+    EXPECT_FALSE(H5Browser::parseRange("1:2:3").has_value());
+}
+
+TEST(H5BrowserTest, MissingFileHasNoDatasets)
+{
+    EXPECT_TRUE(H5Browser::listDatasets("data/does_not_exist.mat").empty());
+}
+
+TEST(H5BrowserTest, SelectionIsPassedAsLoadArgs)
+{
+    DataSourceModel dataSource;
+    dataSource.setFile(QFileInfo("data/signals.mat"));
+    dataSource.setParameter("dataset", "/grp/signal");
+    dataSource.setParameter("rows", "100:200");
+
+    auto args = dataSource.loadArgs();
+    ASSERT_EQ(args.size(), 3u);
+    EXPECT_EQ(args[0].first, "dataset");
+    EXPECT_EQ(args[0].second, "'/grp/signal'");
+    EXPECT_EQ(args[1].second, "100");
+    EXPECT_EQ(args[2].second, "200");
+}
+
+TEST(H5BrowserTest, DatasetIsQuotedForYaml)
+{
+    DataSourceModel dataSource;
+    dataSource.setFile(QFileInfo("data/signals.mat"));
+    dataSource.setParameter("dataset", "/grp/it's \"a\"\\b");
+
+    auto args = dataSource.loadArgs();
+    ASSERT_EQ(args.size(), 1u);
+    EXPECT_EQ(args[0].second, "'/grp/it''s \"a\"\\b'");
+}
+
+TEST(H5BrowserTest, ScalarsHaveNoRows)
+{
+    H5DatasetInfo scalar{"/scalar", {}, "float"};
+    EXPECT_TRUE(scalar.isScalar());
+    H5DatasetInfo matlabScalar{"/matlab", {1, 1}, "float"};
+    EXPECT_TRUE(matlabScalar.isScalar());
+    H5DatasetInfo column{"/column", {100, 1}, "float"};
+    EXPECT_FALSE(column.isScalar());
+}
@@ -0,0 +1,78 @@
+#include "data/block_manager.hpp"
+#include "data/custom_graph.hpp"
+#include "ui/lod_node_painter.hpp"
+#include "ui/models/io_models.hpp"
+#include <gtest/gtest.h>
+#include <QImage>
+#include <QPainter>
+#include <QSet>
+
+#include <QtNodes/DagGraphicsScene>
+#include <QtNodes/DefaultNodePainter>
+#include <QtNodes/NodeGraphicsObject>
+
+using Detail = LodNodePainter::Detail;
+
+namespace {
+QImage paintNode(const QtNodes::AbstractNodePainter &nodePainter,
+                 QtNodes::NodeGraphicsObject &node,
+                 const QSize &size,
+                 double scale)
+{
+    QImage image((QSizeF(size) * scale).toSize(), QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.scale(scale, scale);
+    nodePainter.paint(&painter, node);
+    return image;
+}
+
+// colours inside the block, the outline left out
+QSet<QRgb> innerColors(const QImage &image)
+{
+    QSet<QRgb> result;
+    for (int y = 2; y < image.height() - 2; ++y)
+        for (int x = 2; x < image.width() - 2; ++x)
+            result.insert(image.pixel(x, y));
+    return result;
+}
+} // namespace
+
+TEST(LodNodePainterTest, DetailFollowsScale)
+{
+    EXPECT_EQ(LodNodePainter::detail(1.0), Detail::Full);
+    EXPECT_EQ(LodNodePainter::detail(LodNodePainter::FULL_DETAIL), Detail::Full);
+    EXPECT_EQ(LodNodePainter::detail(0.5), Detail::Caption);
+    EXPECT_EQ(LodNodePainter::detail(LodNodePainter::CAPTION_DETAIL), Detail::Caption);
+    EXPECT_EQ(LodNodePainter::detail(0.1), Detail::Box);
+}
+
+TEST(LodNodePainterTest, OnlyShortConnectionsAreCached)
+{
+    QRectF shortConnection(0, 0, 200, 100);
+    EXPECT_TRUE(LodNodePainter::cacheConnection(shortConnection, 1.0));
+    // the same connection zoomed in needs a pixmap four hundred times as large
+    EXPECT_FALSE(LodNodePainter::cacheConnection(shortConnection, 20.0));
+    QRectF longConnection(0, 0, 5000, 2000);
+    EXPECT_FALSE(LodNodePainter::cacheConnection(longConnection, 1.0));
+    EXPECT_TRUE(LodNodePainter::cacheConnection(longConnection, 0.1));
+}
+
+TEST(LodNodePainterTest, ZoomedOutBlocksArePaintedAsBoxes)
+{
+    CustomGraph graph(BlockManager::getRegistry());
+    QtNodes::DagGraphicsScene scene(graph);
+    auto nodeId = graph.addNode(io_names::DATA_SOURCE);
+    auto node = scene.nodeGraphicsObject(nodeId);
+    ASSERT_NE(node, nullptr);
+    auto size = scene.nodeGeometry().size(nodeId);
+
+    // below the caption detail
+    const double scale = 0.25;
+    ASSERT_EQ(LodNodePainter::detail(scale), Detail::Box);
+    auto lod = paintNode(LodNodePainter(), *node, size, scale);
+    auto stock = paintNode(QtNodes::DefaultNodePainter(), *node, size, scale);
+    // a flat box, no gradient, caption, ports or content
+    EXPECT_EQ(innerColors(lod).size(), 1);
+    EXPECT_GT(innerColors(stock).size(), 1);
+}
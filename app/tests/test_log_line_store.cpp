@@ -0,0 +1,73 @@
+#include "ui/log_line_store.hpp"
+#include "ui/log_panel.hpp"
+#include <gtest/gtest.h>
+
+TEST(LogLineStoreTest, SpilledChunksAreReadBack)
+{
+    LogLineStore store;
+    const size_t LINES = LogLineStore::CHUNK_LINES * (LogLineStore::RESIDENT_CHUNKS + 4);
+    for (size_t i = 0; i < LINES; ++i)
+        store.append({QString("line %1").arg(i), i % 10 == 0 ? QtWarningMsg : QtInfoMsg, "io"});
+    EXPECT_EQ(store.size(), LINES);
+    EXPECT_LE(store.residentChunks(), LogLineStore::RESIDENT_CHUNKS + 1);
+
+    // the first chunk was spilled and is loaded again
+    EXPECT_EQ(store.text(5), "line 5");
+    EXPECT_EQ(store.text(LINES - 1), QString("line %1").arg(LINES - 1));
+    EXPECT_EQ(store.type(10), QtWarningMsg);
+    EXPECT_EQ(store.categories(), QStringList{"io"});
+    EXPECT_LE(store.residentChunks(), LogLineStore::RESIDENT_CHUNKS + 1);
+}
+
+TEST(LogLineStoreTest, FindSkipsRejectedLines)
+{
+    LogLineStore store;
+    store.append({"Kedro run started", QtInfoMsg, "engine"});
+    store.append({"propagating block 3", QtDebugMsg, "graph"});
+    store.append({"kedro RUN finished", QtInfoMsg, "engine"});
+    auto all = [](size_t) { return true; };
+    EXPECT_EQ(store.find("kedro run", 0, all), 0);
+    EXPECT_EQ(store.find("kedro run", 1, all), 2);
+    EXPECT_EQ(store.find("missing", 0, all), LogLineStore::NOT_FOUND);
+    auto graphOnly = [&store](size_t line) { return store.category(line) == 1; };
+    EXPECT_EQ(store.find("block", 0, graphOnly), 1);
+    EXPECT_EQ(store.find("kedro", 0, graphOnly), LogLineStore::NOT_FOUND);
+}
+
+TEST(LogLineStoreTest, MissingQuerySkipsSpilledChunks)
+{
+    LogLineStore store;
+    const size_t LINES = LogLineStore::CHUNK_LINES * (LogLineStore::RESIDENT_CHUNKS + 8);
+    // scattered words, so every chunk sets tens of thousands of distinct trigrams
+    for (size_t i = 0; i < LINES; ++i)
+        store.append({QString("%1 %2 block_%3")
+                          .arg(QString::number(i * 2654435761ULL % 2176782336ULL, 36))
+                          .arg(QString::number(i * 40503ULL % 2176782336ULL, 36))
+                          .arg(i),
+                      QtInfoMsg,
+                      "graph"});
+    auto loads = store.loads();
+    auto all = [](size_t) { return true; };
+    EXPECT_EQ(store.find("kedro run finished", 0, all), LogLineStore::NOT_FOUND);
+    // at most the odd false positive is read back from disk
+    EXPECT_LE(store.loads() - loads, 2);
+    EXPECT_EQ(store.find("block_5", 0, all), 5);
+}
+
+TEST(LogLineStoreTest, ModelInsertsRowsAfterAnnouncingThem)
+{
+    LogListModel model;
+    std::vector<int> countsBefore;
+    QObject::connect(&model,
+                     &QAbstractItemModel::rowsAboutToBeInserted,
+                     [&](const QModelIndex &, int first, int last) {
+                         EXPECT_EQ(model.rowCount(), first);
+                         countsBefore.push_back(last - first + 1);
+                     });
+    model.append({{"first", QtInfoMsg, "test"}, {"second", QtWarningMsg, "test"}});
+    model.setMinimumLevel(QtWarningMsg);
+    model.append({{"third", QtInfoMsg, "test"}, {"fourth", QtCriticalMsg, "test"}});
+    EXPECT_EQ(countsBefore, (std::vector<int>{2, 1}));
+    EXPECT_EQ(model.rowCount(), 2);
+    EXPECT_EQ(model.data(model.index(1)).toString(), "fourth");
+}
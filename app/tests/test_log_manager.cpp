@@ -0,0 +1,46 @@
+#include "log_manager.hpp"
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+TEST(LogManagerTest, JsonLineHoldsRecordFields)
+{
+    LogRecord record{{"[warning] graph: cycle", QtWarningMsg, "descartes.graph"},
+                     "cycle",
+                     1700000000123,
+                     "custom_graph.cpp",
+                     "CustomGraph::addConnection",
+                     42};
+    auto line = LogManager::toJsonLine(record);
+    ASSERT_TRUE(line.endsWith('\n'));
+    // one object per line
+    EXPECT_EQ(line.count('\n'), 1);
+
+    auto object = QJsonDocument::fromJson(line).object();
+    auto time = QDateTime::fromString(object["time"].toString(), Qt::ISODateWithMs);
+    EXPECT_EQ(time.toMSecsSinceEpoch(), 1700000000123);
+    EXPECT_EQ(object["level"].toString(), "warning");
+    EXPECT_EQ(object["category"].toString(), "descartes.graph");
+    EXPECT_EQ(object["message"].toString(), "cycle");
+    EXPECT_EQ(object["file"].toString(), "custom_graph.cpp");
+    EXPECT_EQ(object["line"].toInt(), 42);
+    EXPECT_EQ(object["function"].toString(), "CustomGraph::addConnection");
+}
+
+TEST(LogManagerTest, JsonLineWithoutCallSite)
+{
+    LogRecord record{{"[error] multi\nline", QtCriticalMsg, "descartes.log"},
+                     "multi\nline",
+                     0};
+    auto line = LogManager::toJsonLine(record);
+    // the newline of the message is escaped
+    EXPECT_EQ(line.count('\n'), 1);
+
+    auto object = QJsonDocument::fromJson(line).object();
+    EXPECT_EQ(object["level"].toString(), "error");
+    EXPECT_EQ(object["message"].toString(), "multi\nline");
+    EXPECT_FALSE(object.contains("file"));
+    EXPECT_FALSE(object.contains("line"));
+    EXPECT_FALSE(object.contains("function"));
+}
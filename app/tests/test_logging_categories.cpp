@@ -0,0 +1,18 @@
+#include "logging_categories.hpp"
+#include <gtest/gtest.h>
+
+TEST(LoggingCategoriesTest, DebugIsEnabledPerSubsystem)
+{
+    logging::setDebugSubsystems({});
+    EXPECT_FALSE(lcEngine().isDebugEnabled());
+    EXPECT_TRUE(lcEngine().isInfoEnabled());
+
+    logging::setDebugSubsystems({"engine", "io"});
+    EXPECT_TRUE(lcEngine().isDebugEnabled());
+    EXPECT_TRUE(lcIo().isDebugEnabled());
+    EXPECT_FALSE(lcGraph().isDebugEnabled());
+    EXPECT_TRUE(lcGraph().isWarningEnabled());
+
+    logging::setDebugSubsystems({});
+    EXPECT_FALSE(lcIo().isDebugEnabled());
+}
@@ -0,0 +1,180 @@
+#include "data/custom_graph.hpp"
+#include "data/tab_components.hpp"
+#include "ui/models/coder_models.hpp"
+#include "ui/models/io_models.hpp"
+#include "ui/models/processor_models.hpp"
+#include <gtest/gtest.h>
+#include <QGraphicsSceneMouseEvent>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <QtNodes/DagGraphicsScene>
+#include <QtNodes/NodeGraphicsObject>
+
+namespace {
+QString loadArg(const DataSourceModel &source, const QString &key)
+{
+    for (const auto &arg : source.loadArgs())
+        if (arg.first == key)
+            return arg.second;
+    return QString();
+}
+} // namespace
+
+TEST(ModelsTest, CompressionLevelIsClampedToCodec)
+{
+    DataOutModel output;
+    output.setCompressionLevel(40);
+    // uncompressed outputs keep the level for a later codec
+    EXPECT_EQ(output.getCompressionLevel(), 40);
+    output.setCodec(Codec::Zstd);
+    EXPECT_EQ(output.getCompressionLevel(), 22);
+    output.setCodec(Codec::Lz4);
+    EXPECT_EQ(output.getCompressionLevel(), 12);
+    output.setCompressionLevel(0);
+    EXPECT_EQ(output.getCompressionLevel(), 1);
+    output.setParameter(OutputModel::COMPRESSION_LEVEL, "-5");
+    EXPECT_EQ(output.getCompressionLevel(), 1);
+}
+
+TEST(ModelsTest, ChunkedSourcesDeclareLoadArgs)
+{
+    DataSourceModel csv;
+    csv.setFile(QFileInfo("data/flux_a.csv"));
+    EXPECT_TRUE(loadArg(csv, "chunksize").isEmpty());
+    csv.setChunkSize(500);
+    EXPECT_TRUE(csv.isChunked());
+    EXPECT_EQ(loadArg(csv, "chunksize"), "500");
+
+    // h5 sources are read in hyperslabs by the backend, the file only has to have the suffix
+    DataSourceModel h5;
+    h5.setFile(QFileInfo("data/chunked.mat"));
+    h5.setChunkSize(64);
+    EXPECT_EQ(loadArg(h5, "chunk_size"), "64");
+    EXPECT_TRUE(loadArg(h5, "chunksize").isEmpty());
+}
+
+TEST(ModelsTest, ChunkedPortsReachOnlyStreamingBlocks)
+{
+    DataSourceModel source;
+    source.setFile(QFileInfo("data/flux_a.csv"));
+    source.setChunkSize(100);
+    auto descriptor = source.outPortDescriptor(0);
+    ASSERT_TRUE(descriptor.chunked);
+
+    SplitDataModel split;
+    EXPECT_FALSE(split.acceptsConnection(descriptor, 0));
+    DifferenceModel difference;
+    EXPECT_TRUE(difference.acceptsConnection(descriptor, 0));
+
+    // the difference streams its input and hands chunks on
+    EXPECT_FALSE(difference.outPortDescriptor(0).chunked);
+    difference.setInData(source.outData(0), 0);
+    EXPECT_TRUE(difference.outPortDescriptor(0).chunked);
+    difference.setInData(nullptr, 0);
+    EXPECT_FALSE(difference.outPortDescriptor(0).chunked);
+}
+
+TEST(ModelsTest, DragCheckRejectsNonSingularFunctions)
+{
+    SensitivityAnalysisModel sensitivity;
+    FunctionNode singular;
+    singular.setSignature({{1}, {2}});
+    EXPECT_TRUE(sensitivity.acceptsConnection(singular.descriptor(), 0));
+    FunctionNode twoInputs;
+    twoInputs.setSignature({{1, 2}, {3}});
+    EXPECT_FALSE(sensitivity.acceptsConnection(twoInputs.descriptor(), 0));
+
+    // a type mismatch can still be overridden on release, the drag check lets it through
+    DataNode data("drag_check");
+    EXPECT_TRUE(sensitivity.acceptsConnection(data.descriptor(), 0));
+}
+
+TEST(ModelsTest, PortsAreIndexedByKind)
+{
+    TransformDataModel block;
+    block.setInputPortNumber(3);
+    EXPECT_EQ(block.nPorts(PortType::In, DataPort), 3);
+    EXPECT_EQ(block.nPorts(PortType::Out, FunctionPort), 2);
+    EXPECT_EQ(block.nPorts(PortType::Out, DataPort), 0);
+    EXPECT_FALSE(block.hasDataOutPorts());
+
+    EXPECT_EQ(block.outPort<DataNode>(0), nullptr);
+    EXPECT_NE(block.outPort<FunctionNode>(1), nullptr);
+    EXPECT_NE(block.outPort<NamedNode>(1), nullptr);
+    EXPECT_EQ(block.outPort<FunctionNode>(2), nullptr);
+
+    block.setInputPortNumber(1);
+    EXPECT_EQ(block.nPorts(PortType::In), 1);
+}
+
+TEST(ModelsTest, ParameterSchemaIsSharedByBlockType)
+{
+    TransformDataModel first;
+    TransformDataModel second;
+    auto schema = first.getParameterSchema();
+    EXPECT_EQ(schema.begin(), second.getParameterSchema().begin());
+    EXPECT_TRUE(first.hasParameters());
+
+    auto values = first.getParameters();
+    for (const auto &parameter : schema)
+        EXPECT_EQ(values.count(*parameter.key), 1);
+    EXPECT_EQ(*schema.begin()->key, CoderModel::PROCESS);
+}
+
+TEST(ModelsTest, BlockOutsideGraphPushesOutputsDirectly)
+{
+    DataSourceModel source;
+    QSignalSpy updated(&source, &FdfBlockModel::dataUpdated);
+    source.propagateUpdate();
+    EXPECT_EQ(updated.count(), static_cast<int>(source.nPorts(PortType::Out)));
+}
+
+TEST(ModelsTest, GraphIsScaledToBoundedContent)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QFileInfo file(dir.filePath("graph.png"));
+    QImage tall(100, 4000, QImage::Format_RGB32);
+    tall.fill(Qt::white);
+    ASSERT_TRUE(tall.save(file.absoluteFilePath()));
+
+    GraphModel graph;
+    graph.setFile(file);
+    auto size = graph.contentSize();
+    EXPECT_FALSE(size.isEmpty());
+    EXPECT_LE(size.width(), 320);
+    EXPECT_LE(size.height(), 240);
+}
+
+TEST(ModelsTest, PressOnImportButtonReachesDataSource)
+{
+    TabComponents tab(nullptr);
+    auto graph = tab.getGraph();
+    auto scene = tab.getScene();
+    // the tab would open a file dialog
+    QObject::disconnect(graph, &CustomGraph::dataSourceModelImportClicked, &tab, nullptr);
+    QSignalSpy imported(graph, &CustomGraph::dataSourceModelImportClicked);
+    auto nodeId = graph->addNode(io_names::DATA_SOURCE);
+    auto node = scene->nodeGraphicsObject(nodeId);
+    ASSERT_NE(node, nullptr);
+    auto content = graph->delegateModel<DataSourceModel>(nodeId)->contentRect(
+        scene->nodeGeometry().size(nodeId));
+
+    auto press = [&](const QPointF &position) {
+        QGraphicsSceneMouseEvent event(QEvent::GraphicsSceneMousePress);
+        event.setButton(Qt::LeftButton);
+        event.setScenePos(node->mapToScene(position));
+        return tab.eventFilter(scene, &event);
+    };
+    // the file name line above the button is not handled
+    EXPECT_FALSE(press(content.center() - QPointF(0, content.height() / 4)));
+    EXPECT_EQ(imported.count(), 0);
+    // outside the content the press is left to the scene
+    EXPECT_FALSE(press(content.topLeft() - QPointF(0, 10)));
+    EXPECT_EQ(imported.count(), 0);
+    EXPECT_TRUE(press(content.center() + QPointF(0, content.height() / 4)));
+    ASSERT_EQ(imported.count(), 1);
+    EXPECT_EQ(imported.first().first().toUInt(), nodeId);
+}
@@ -0,0 +1,52 @@
+#include "mpsc_ring_buffer.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(MpscRingBufferTest, FullQueueRejectsPushes)
+{
+    MpscRingBuffer<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.tryPush(int(i)));
+    EXPECT_FALSE(queue.tryPush(4));
+
+    int value = -1;
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 0);
+    // the freed cell is reused on the next lap
+    EXPECT_TRUE(queue.tryPush(4));
+    for (int expected = 1; expected <= 4; ++expected) {
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(MpscRingBufferTest, ProducersKeepTheirOrder)
+{
+    const int PRODUCERS = 4;
+    const int PER_PRODUCER = 20000;
+    MpscRingBuffer<std::pair<int, int>> queue(1024);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < PER_PRODUCER;)
+                if (queue.tryPush({p, i}))
+                    ++i;
+        });
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    std::pair<int, int> value;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (!queue.tryPop(value))
+            continue;
+        EXPECT_EQ(value.second, next.at(value.first));
+        next.at(value.first) = value.second + 1;
+        ++received;
+    }
+    for (auto &producer : producers)
+        producer.join();
+    EXPECT_FALSE(queue.tryPop(value));
+}
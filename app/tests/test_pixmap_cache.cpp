@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <QImage>
+#include <QTemporaryDir>
+
+#include <QtUtility/media/pixmap_cache.hpp>
+
+using PixmapCache = QtUtility::media::PixmapCache;
+
+TEST(PixmapCacheTest, EvictsWithinByteBudget)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QStringList paths;
+    for (int i = 0; i < 3; ++i) {
+        QImage image(100, 100, QImage::Format_RGB32);
+        image.fill(Qt::green);
+        paths << dir.filePath(QString("plot%1.png").arg(i));
+        ASSERT_TRUE(image.save(paths.last(), "PNG"));
+    }
+
+    auto &cache = PixmapCache::instance();
+    auto budget = cache.byteBudget();
+    // room for two decoded plots
+    cache.setByteBudget(2 * 100 * 100 * 4);
+    for (const auto &path : paths) {
+        auto pixmap = cache.pixmap(path);
+        ASSERT_FALSE(pixmap.isNull());
+        EXPECT_EQ(pixmap.size(), QSize(100, 100));
+        EXPECT_LE(cache.cachedBytes(), cache.byteBudget());
+    }
+    EXPECT_GT(cache.cachedBytes(), 0);
+    EXPECT_TRUE(cache.pixmap(dir.filePath("missing.png")).isNull());
+
+    cache.setByteBudget(0);
+    EXPECT_EQ(cache.cachedBytes(), 0);
+    cache.setByteBudget(budget);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <QtUtility/media/thumbnail_loader.hpp>
+
+using ThumbnailLoader = QtUtility::media::ThumbnailLoader;
+
+namespace {
+ThumbnailLoader &loader()
+{
+    // keeps the disk cache out of the user's cache directory
+    QStandardPaths::setTestModeEnabled(true);
+    return ThumbnailLoader::instance();
+}
+
+void writeFile(const QString &path, qint64 bytes, const QDateTime &modified)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(bytes, 'x'));
+    ASSERT_TRUE(file.setFileTime(modified, QFileDevice::FileModificationTime));
+}
+} // namespace
+
+TEST(ThumbnailLoaderTest, DecodesOnceAndCaches)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto path = dir.filePath("plot.png");
+    QImage image(800, 400, QImage::Format_RGB32);
+    image.fill(Qt::blue);
+    ASSERT_TRUE(image.save(path, "PNG"));
+
+    auto &thumbnails = loader();
+    QSignalSpy ready(&thumbnails, &ThumbnailLoader::thumbnailReady);
+    EXPECT_TRUE(thumbnails.thumbnail(path).isNull());
+    // a second request while decoding is not queued again
+    EXPECT_TRUE(thumbnails.thumbnail(path).isNull());
+    ASSERT_TRUE(ready.wait(5000));
+    EXPECT_EQ(ready.count(), 1);
+    EXPECT_EQ(ready.at(0).at(0).toString(), path);
+
+    auto thumbnail = thumbnails.thumbnail(path);
+    ASSERT_FALSE(thumbnail.isNull());
+    EXPECT_EQ(thumbnail.width(), ThumbnailLoader::THUMBNAIL_SIZE);
+    EXPECT_EQ(thumbnail.height(), ThumbnailLoader::THUMBNAIL_SIZE / 2);
+}
+
+TEST(ThumbnailLoaderTest, MissingFileIsNotQueued)
+{
+    auto &thumbnails = loader();
+    QSignalSpy ready(&thumbnails, &ThumbnailLoader::thumbnailReady);
+    QSignalSpy failed(&thumbnails, &ThumbnailLoader::thumbnailFailed);
+    EXPECT_TRUE(thumbnails.thumbnail("does/not/exist.png").isNull());
+    EXPECT_FALSE(ready.wait(200));
+    EXPECT_EQ(failed.count(), 0);
+}
+
+TEST(ThumbnailLoaderTest, FailedDecodeIsNotRetried)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto path = dir.filePath("broken.png");
+    writeFile(path, 64, QDateTime::currentDateTime());
+
+    auto &thumbnails = loader();
+    QSignalSpy failed(&thumbnails, &ThumbnailLoader::thumbnailFailed);
+    EXPECT_TRUE(thumbnails.thumbnail(path).isNull());
+    ASSERT_TRUE(failed.wait(5000));
+    EXPECT_TRUE(thumbnails.thumbnail(path).isNull());
+    EXPECT_FALSE(failed.wait(200));
+    EXPECT_EQ(failed.count(), 1);
+}
+
+TEST(ThumbnailLoaderTest, PruneRemovesOldFilesThenOldestOverBudget)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    auto now = QDateTime::currentDateTime();
+    writeFile(dir.filePath("expired.png"), 100, now.addDays(-40));
+    writeFile(dir.filePath("older.png"), 1000, now.addDays(-2));
+    writeFile(dir.filePath("newer.png"), 1000, now.addDays(-1));
+
+    ThumbnailLoader::pruneDiskCache(dir.path(), 1500, 30);
+    EXPECT_EQ(QDir(dir.path()).entryList(QDir::Files), QStringList{"newer.png"});
+}
@@ -1,7 +1,10 @@
+#include "data/custom_graph.hpp"
+#include "data/tab_manager.hpp"
 #include "ui/models/io_models.hpp"
 #include "ui/models/uid_manager.hpp"
 #include <gtest/gtest.h>
 #include <memory>
+#include <QCoreApplication>
 #include <QFileInfo>
 
 std::shared_ptr<DataNode> fetchDataNodeFromFile(const QString &filePath)
@@ -66,3 +69,120 @@ TEST(UIDManagerTest, InvalidUIDReturnsEmptyTag)
 
     ASSERT_TRUE(tag == UIDManager::NONE_TAG);
 }
+
+TEST(UIDManagerTest, OverrideUpdatesIndexedPorts)
+{
+    auto uidManager = TabManager::getUIDManager();
+    auto kept = std::make_shared<DataNode>("override_kept");
+    auto removed = std::make_shared<DataNode>("override_removed");
+    auto function = std::make_shared<FunctionNode>();
+    function->setSignature({{kept->typeId(), removed->typeId()}, {removed->typeId()}});
+    FdfUID removedId = removed->typeId();
+    ASSERT_EQ(uidManager->referenceCount(removedId), 2);
+
+    removed->setTypeTagName(kept->typeTagName());
+
+    EXPECT_EQ(removed->typeId(), kept->typeId());
+    EXPECT_EQ(uidManager->referenceCount(removedId), 0);
+    EXPECT_EQ(uidManager->referenceCount(kept->typeId()), 3);
+    auto signature = function->signature();
+    EXPECT_EQ(signature.inputs.at(1), kept->typeId());
+    EXPECT_EQ(signature.outputs.at(0), kept->typeId());
+}
+
+// a rename visits only the ports referencing the type, whatever the number of other ports
+TEST(UIDManagerTest, RenameVisitsOnlyReferencingPorts)
+{
+    auto uidManager = TabManager::getUIDManager();
+    std::vector<std::shared_ptr<DataNode>> unrelated;
+    for (int i = 0; i < 1000; ++i)
+        unrelated.push_back(std::make_shared<DataNode>(QString("rename_unrelated_%1").arg(i)));
+    auto renamed = std::make_shared<DataNode>("rename_renamed");
+    auto sameType = std::make_shared<DataNode>(renamed->typeId());
+    auto function = std::make_shared<FunctionNode>();
+    function->setSignature({{renamed->typeId()}, {unrelated.front()->typeId()}});
+    ASSERT_EQ(uidManager->referenceCount(renamed->typeId()), 3);
+
+    renamed->setTypeTagName("rename_renamed_again");
+    EXPECT_EQ(uidManager->visitedPortCount(), 3);
+    EXPECT_EQ(sameType->typeTagName(), "rename_renamed_again");
+    EXPECT_EQ(uidManager->referenceCount(renamed->typeId()), 3);
+}
+
+TEST(UIDManagerTest, PortsOutliveTheirTab)
+{
+    auto tab = std::make_unique<TabComponents>(nullptr);
+    auto uidManager = tab->getTabUIDManager().get();
+    auto graph = tab->getGraph();
+    auto fallbackPorts = TabManager::getUIDManager()->boundPortCount();
+    // built by the graph, bound to its tab and not the current one
+    auto sourceId = graph->addNode(io_names::DATA_SOURCE);
+    EXPECT_GT(uidManager->boundPortCount(), 0);
+    EXPECT_EQ(TabManager::getUIDManager()->boundPortCount(), fallbackPorts);
+
+    // ports that bind without being indexed
+    std::shared_ptr<DataNode> untyped;
+    std::shared_ptr<FunctionNode> noSignature;
+    {
+        UIDManager::Binding binding(uidManager);
+        untyped = std::make_shared<DataNode>();
+        noSignature = std::make_shared<FunctionNode>();
+        noSignature->setSignature(Signature());
+    }
+    EXPECT_EQ(untyped->typeId(), UIDManager::NONE_ID);
+    auto held = graph->delegateModel<DataSourceModel>(sourceId)->outData(0);
+
+    // the graph is only deleted later, the ports must not reach the destroyed manager
+    tab.reset();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    untyped.reset();
+    noSignature.reset();
+    held.reset();
+}
+
+TEST(UIDManagerTest, EqualSignaturesShareHandle)
+{
+    UIDManager uidManager;
+    auto &table = uidManager.signatures();
+    SignatureId first = table.intern({{1, 2}, {3}});
+    SignatureId second = table.intern({{1, 2}, {3}});
+    SignatureId other = table.intern({{1}, {2, 3}});
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(table.intern(Signature()), SignatureTable::EMPTY_ID);
+    EXPECT_EQ(&table.get(first), &table.get(second));
+
+    FunctionNode function;
+    {
+        UIDManager::Binding binding(&uidManager);
+        function.setSignature({{1, 2}, {3}});
+    }
+    EXPECT_EQ(function.signatureId(), first);
+    EXPECT_EQ(function.signature(), table.get(first));
+
+    // each project has its own table
+    UIDManager otherProject;
+    EXPECT_EQ(otherProject.signatures().size(), 1);
+}
+
+TEST(UIDManagerTest, TagsAreInternedPerProject)
+{
+    auto interner = std::make_shared<StringInterner>();
+    UIDManager uidManager(interner);
+    FdfUID id = uidManager.createUID("shared_tag");
+    Atom atom = interner->find("shared_tag");
+    ASSERT_NE(atom, StringInterner::NO_ATOM);
+    EXPECT_EQ(interner->intern("shared_tag"), atom);
+    // the tag handed out is the interned copy
+    EXPECT_EQ(uidManager.getTag(id), interner->string(atom));
+    EXPECT_EQ(uidManager.getUid("shared_tag"), id);
+
+    // probing for a unique tag does not grow the table
+    auto size = interner->size();
+    EXPECT_EQ(uidManager.getUniqueTag("shared_tag"), "shared_tag_1");
+    EXPECT_EQ(interner->size(), size);
+
+    UIDManager otherProject;
+    EXPECT_EQ(otherProject.getUid("shared_tag"), UIDManager::NONE_ID);
+}